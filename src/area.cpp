@@ -18,7 +18,7 @@
 
 namespace exactextract {
 
-    double area_signed(const std::vector<Coordinate> &ring) {
+    double area_signed(const CoordinateRange &ring) {
         if (ring.size() < 3) {
             return 0;
         }
@@ -36,8 +36,76 @@ namespace exactextract {
         return sum / 2.0;
     }
 
-    double area(const std::vector<Coordinate> &ring) {
+    double area_signed(const std::vector<Coordinate> &ring) {
+        return area_signed(CoordinateRange(ring));
+    }
+
+    double area(const CoordinateRange &ring) {
         return std::abs(area_signed(ring));
     }
 
+    double area(const std::vector<Coordinate> &ring) {
+        return area(CoordinateRange(ring));
+    }
+
+    // Clip the closed ring held in `pts` to one side of a box, replacing the
+    // contents of `pts` with the (unclosed) clipped ring.
+    template<typename Inside, typename Intersection>
+    static void clip_side(std::vector<Coordinate> &pts, Inside inside, Intersection intersection) {
+        size_t n = pts.size();
+
+        for (size_t i = 0; i < n; i++) {
+            // Copy the coordinates because appending to pts may invalidate references.
+            Coordinate prev = pts[i == 0 ? n - 1 : i - 1];
+            Coordinate curr = pts[i];
+
+            bool prev_inside = inside(prev);
+            bool curr_inside = inside(curr);
+
+            if (curr_inside != prev_inside) {
+                pts.push_back(intersection(prev, curr));
+            }
+            if (curr_inside) {
+                pts.push_back(curr);
+            }
+        }
+
+        pts.erase(pts.begin(), pts.begin() + static_cast<std::ptrdiff_t>(n));
+    }
+
+    double clipped_area(const CoordinateRange &ring, const Box &box, std::vector<Coordinate> &scratch) {
+        // Sutherland-Hodgman clipping. When the ring is not convex the clipped
+        // ring may contain degenerate edges along the box, but they do not
+        // contribute to its area.
+        scratch.assign(ring.begin(), ring.end());
+
+        auto at_x = [](const Coordinate &a, const Coordinate &b, double x) {
+            return Coordinate{x, a.y + (b.y - a.y) * (x - a.x) / (b.x - a.x)};
+        };
+        auto at_y = [](const Coordinate &a, const Coordinate &b, double y) {
+            return Coordinate{a.x + (b.x - a.x) * (y - a.y) / (b.y - a.y), y};
+        };
+
+        clip_side(scratch,
+                  [&box](const Coordinate &c) { return c.x >= box.xmin; },
+                  [&](const Coordinate &a, const Coordinate &b) { return at_x(a, b, box.xmin); });
+        clip_side(scratch,
+                  [&box](const Coordinate &c) { return c.x <= box.xmax; },
+                  [&](const Coordinate &a, const Coordinate &b) { return at_x(a, b, box.xmax); });
+        clip_side(scratch,
+                  [&box](const Coordinate &c) { return c.y >= box.ymin; },
+                  [&](const Coordinate &a, const Coordinate &b) { return at_y(a, b, box.ymin); });
+        clip_side(scratch,
+                  [&box](const Coordinate &c) { return c.y <= box.ymax; },
+                  [&](const Coordinate &a, const Coordinate &b) { return at_y(a, b, box.ymax); });
+
+        if (scratch.empty()) {
+            return 0;
+        }
+
+        scratch.push_back(scratch.front());
+
+        return area(CoordinateRange(scratch));
+    }
+
 }
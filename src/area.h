@@ -18,14 +18,25 @@
 #include <vector>
 #include <cstddef>
 
+#include "box.h"
 #include "coordinate.h"
 
 namespace exactextract {
 
+    double area_signed(const CoordinateRange &ring);
+
     double area_signed(const std::vector<Coordinate> &ring);
 
+    double area(const CoordinateRange &ring);
+
     double area(const std::vector<Coordinate> &ring);
 
+    /**
+     * Return the area of the intersection of a ring with a box, using
+     * `scratch` as working storage for the clipped ring.
+     */
+    double clipped_area(const CoordinateRange &ring, const Box &box, std::vector<Coordinate> &scratch);
+
 }
 
 #endif
\ No newline at end of file
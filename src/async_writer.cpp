@@ -0,0 +1,131 @@
+// Copyright (c) 2021 ISciences, LLC.
+// All rights reserved.
+//
+// This software is licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License. You may
+// obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0.
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "async_writer.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace exactextract {
+
+    AsyncWriter::AsyncWriter(OutputWriter & writer, size_t queue_size) :
+        m_writer{writer},
+        m_queue_size{std::max(queue_size, static_cast<size_t>(1))},
+        m_reg{nullptr}
+    {
+        m_writer.set_registry(&m_writer_reg);
+    }
+
+    AsyncWriter::~AsyncWriter() {
+        // If finish() was not called, probably because of an error, discard
+        // any queued results and stop the writer thread without reporting any
+        // error it raised.
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_queue.clear();
+        }
+        stop();
+    }
+
+    void AsyncWriter::add_operation(const Operation & op) {
+        m_writer.add_operation(op);
+        m_writer_reg.add_operation(op);
+
+        m_ops.push_back(&op);
+    }
+
+    void AsyncWriter::set_registry(const StatsRegistry* reg) {
+        m_reg = reg;
+    }
+
+    void AsyncWriter::write(const FeatureId & fid) {
+        // The thread is started with the first result, once all operations
+        // have been added.
+        if (!m_thread.joinable()) {
+            m_thread = std::thread(&AsyncWriter::run, this);
+        }
+
+        auto result = m_reg->result(fid);
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_not_full.wait(lock, [this]() { return m_queue.size() < m_queue_size || m_error; });
+
+        rethrow_error();
+
+        m_queue.push_back(std::move(result));
+        m_not_empty.notify_one();
+    }
+
+    void AsyncWriter::finish() {
+        stop();
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            rethrow_error();
+        }
+
+        m_writer.finish();
+    }
+
+    void AsyncWriter::run() {
+        while (true) {
+            FeatureResult result;
+
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_not_empty.wait(lock, [this]() { return !m_queue.empty() || m_done; });
+
+                if (m_queue.empty()) {
+                    return;
+                }
+
+                result = std::move(m_queue.front());
+                m_queue.pop_front();
+                m_not_full.notify_one();
+            }
+
+            FeatureId fid = result.id;
+
+            try {
+                m_writer_reg.insert(std::move(result));
+                m_writer.write(fid);
+                m_writer_reg.flush_feature(fid);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_error = std::current_exception();
+                m_queue.clear();
+                m_not_full.notify_all();
+                return;
+            }
+        }
+    }
+
+    void AsyncWriter::stop() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_done = true;
+        }
+        m_not_empty.notify_one();
+
+        if (m_thread.joinable()) {
+            m_thread.join();
+        }
+    }
+
+    void AsyncWriter::rethrow_error() {
+        if (m_error) {
+            std::rethrow_exception(m_error);
+        }
+    }
+
+}
@@ -0,0 +1,85 @@
+// Copyright (c) 2021 ISciences, LLC.
+// All rights reserved.
+//
+// This software is licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License. You may
+// obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0.
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef EXACTEXTRACT_ASYNC_WRITER_H
+#define EXACTEXTRACT_ASYNC_WRITER_H
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+#include "output_writer.h"
+#include "stats_registry.h"
+
+namespace exactextract {
+
+    /**
+     * An OutputWriter that passes results to another writer on a separate
+     * thread, so that a slow output does not stall processing.
+     *
+     * When a feature is written, its stats are copied from the processor's
+     * registry into a FeatureResult and placed in a queue of bounded size,
+     * so that the processor can flush the feature immediately. The writer
+     * thread moves each result into a registry of its own before writing it
+     * with the wrapped writer.
+     */
+    class AsyncWriter : public OutputWriter {
+    public:
+        /**
+         * @param writer      writer to which results are passed
+         * @param queue_size  number of results that may be waiting to be
+         *                    written before write() blocks
+         */
+        explicit AsyncWriter(OutputWriter & writer, size_t queue_size = 1024);
+
+        ~AsyncWriter() override;
+
+        void add_operation(const Operation & op) override;
+
+        void set_registry(const StatsRegistry* reg) override;
+
+        void write(const FeatureId & fid) override;
+
+        /**
+         * Wait for all queued results to be written, then finish the wrapped
+         * writer. Any error raised by the wrapped writer is rethrown.
+         */
+        void finish() override;
+
+    private:
+        void run();
+
+        void stop();
+
+        void rethrow_error();
+
+        OutputWriter& m_writer;
+        size_t m_queue_size;
+
+        const StatsRegistry* m_reg;
+        StatsRegistry m_writer_reg;
+
+        std::thread m_thread;
+        std::mutex m_mutex;
+        std::condition_variable m_not_empty;
+        std::condition_variable m_not_full;
+        std::deque<FeatureResult> m_queue;
+        std::exception_ptr m_error;
+        bool m_done = false;
+    };
+
+}
+
+#endif //EXACTEXTRACT_ASYNC_WRITER_H
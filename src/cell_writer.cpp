@@ -0,0 +1,66 @@
+// Copyright (c) 2021 ISciences, LLC.
+// All rights reserved.
+//
+// This software is licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License. You may
+// obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0.
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cell_writer.h"
+
+#include <limits>
+#include <memory>
+
+namespace exactextract {
+
+    void CellWriter::write(const FeatureId & fid,
+                           const Operation & op,
+                           const Grid<bounded_extent> & grid,
+                           const Raster<float> & coverage,
+                           const AbstractRaster<double> & values,
+                           const AbstractRaster<double> * weights) {
+        const auto& cov_grid = coverage.grid();
+
+        if (cov_grid.empty()) {
+            return;
+        }
+
+        size_t row0 = grid.row_offset(cov_grid);
+        size_t col0 = grid.col_offset(cov_grid);
+
+        RasterView<double> rv{values, cov_grid};
+        std::unique_ptr<RasterView<double>> wv;
+        if (weights != nullptr) {
+            wv = std::make_unique<RasterView<double>>(*weights, cov_grid);
+        }
+
+        constexpr double nan = std::numeric_limits<double>::quiet_NaN();
+
+        for (size_t i = 0; i < coverage.rows(); i++) {
+            for (size_t j = 0; j < coverage.cols(); j++) {
+                float pct_cov = coverage(i, j);
+                if (pct_cov <= 0) {
+                    continue;
+                }
+
+                double val;
+                if (!rv.get(i, j, val)) {
+                    val = nan;
+                }
+
+                double weight = nan;
+                if (wv && !wv->get(i, j, weight)) {
+                    weight = nan;
+                }
+
+                write_cell(fid, op, row0 + i, col0 + j, pct_cov, val, weight);
+            }
+        }
+    }
+
+}
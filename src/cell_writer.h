@@ -0,0 +1,64 @@
+// Copyright (c) 2021 ISciences, LLC.
+// All rights reserved.
+//
+// This software is licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License. You may
+// obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0.
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef EXACTEXTRACT_CELL_WRITER_H
+#define EXACTEXTRACT_CELL_WRITER_H
+
+#include "feature_id.h"
+#include "grid.h"
+#include "operation.h"
+#include "raster.h"
+
+namespace exactextract {
+
+    /**
+     * Receives the individual cells covered by each feature, rather than
+     * statistics computed from them.
+     */
+    class CellWriter {
+    public:
+        virtual ~CellWriter() = default;
+
+        /**
+         * Write each cell of `coverage` with a nonzero coverage fraction,
+         * along with the values of the operation's rasters at that cell.
+         * Rows and columns are given relative to `grid`, of which the grid
+         * of `coverage` must be a subset.
+         */
+        void write(const FeatureId & fid,
+                   const Operation & op,
+                   const Grid<bounded_extent> & grid,
+                   const Raster<float> & coverage,
+                   const AbstractRaster<double> & values,
+                   const AbstractRaster<double> * weights);
+
+        virtual void finish() {}
+
+    protected:
+        /**
+         * Write a single cell. `value` or `weight` is NaN if the raster has
+         * no data at the cell, and `weight` is NaN if the operation is
+         * unweighted.
+         */
+        virtual void write_cell(const FeatureId & fid,
+                                const Operation & op,
+                                size_t row,
+                                size_t col,
+                                float coverage,
+                                double value,
+                                double weight) = 0;
+    };
+
+}
+
+#endif //EXACTEXTRACT_CELL_WRITER_H
@@ -15,6 +15,7 @@
 #define EXACTEXTRACT_COORDINATE_H
 
 #include <cmath>
+#include <cstddef>
 #include <iostream>
 
 namespace exactextract {
@@ -42,6 +43,34 @@ namespace exactextract {
 
     std::ostream &operator<<(std::ostream &os, const Coordinate &c);
 
+    /**
+     * A non-owning view of a contiguous sequence of Coordinates, such as a
+     * single ring of a FlatGeometry.
+     */
+    class CoordinateRange {
+    public:
+        CoordinateRange(const Coordinate* begin, const Coordinate* end) : m_begin{begin}, m_end{end} {}
+
+        template<typename Container>
+        explicit CoordinateRange(const Container & coords) : m_begin{coords.data()}, m_end{coords.data() + coords.size()} {}
+
+        const Coordinate* begin() const { return m_begin; }
+
+        const Coordinate* end() const { return m_end; }
+
+        const Coordinate& front() const { return *m_begin; }
+
+        const Coordinate& operator[](size_t i) const { return m_begin[i]; }
+
+        size_t size() const { return static_cast<size_t>(m_end - m_begin); }
+
+        bool empty() const { return m_begin == m_end; }
+
+    private:
+        const Coordinate* m_begin;
+        const Coordinate* m_end;
+    };
+
 }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,112 @@
+// Copyright (c) 2021 ISciences, LLC.
+// All rights reserved.
+//
+// This software is licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License. You may
+// obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0.
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "coverage_raster_writer.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+namespace exactextract {
+
+    CoverageRasterWriter::Method CoverageRasterWriter::parse_method(const std::string & name) {
+        if (name == "sum") {
+            return Method::SUM;
+        } else if (name == "max") {
+            return Method::MAX;
+        } else if (name == "argmax") {
+            return Method::ARGMAX;
+        }
+
+        throw std::runtime_error("Unknown coverage method: " + name);
+    }
+
+    void CoverageRasterWriter::begin_window(const Grid<bounded_extent> & grid) {
+        if (m_method == Method::ARGMAX) {
+            Matrix<double> ids(grid.rows(), grid.cols(), std::numeric_limits<double>::quiet_NaN());
+            m_window = std::make_unique<Raster<double>>(std::move(ids), grid);
+            m_max_coverage = std::make_unique<Raster<float>>(grid);
+        } else {
+            m_window = std::make_unique<Raster<double>>(grid);
+        }
+    }
+
+    void CoverageRasterWriter::add(const FeatureId & fid, const Raster<float> & coverage) {
+        if (m_window == nullptr) {
+            throw std::runtime_error("No coverage window has been started.");
+        }
+
+        if (m_method == Method::ARGMAX) {
+            if (!fid.is_int()) {
+                throw std::runtime_error("Coverage method argmax requires integer feature IDs, got " + fid.to_string());
+            }
+
+            // IDs are held as doubles, which represent integers exactly only up to 2^53.
+            constexpr int64_t max_id = int64_t{1} << 53;
+            if (fid.as_int() > max_id || fid.as_int() < -max_id) {
+                throw std::runtime_error("Coverage method argmax cannot store feature ID " + fid.to_string() + " exactly.");
+            }
+        }
+
+        const auto& grid = coverage.grid();
+        if (grid.empty()) {
+            return;
+        }
+
+        size_t row0 = m_window->grid().row_offset(grid);
+        size_t col0 = m_window->grid().col_offset(grid);
+
+        for (size_t i = 0; i < coverage.rows(); i++) {
+            for (size_t j = 0; j < coverage.cols(); j++) {
+                float frac = coverage(i, j);
+                if (frac <= 0) {
+                    continue;
+                }
+
+                double& val = (*m_window)(row0 + i, col0 + j);
+
+                switch (m_method) {
+                    case Method::SUM:
+                        val += static_cast<double>(frac);
+                        break;
+                    case Method::MAX:
+                        val = std::max(val, static_cast<double>(frac));
+                        break;
+                    case Method::ARGMAX: {
+                        // Ties go to the feature processed first
+                        float& max_frac = (*m_max_coverage)(row0 + i, col0 + j);
+                        if (frac > max_frac) {
+                            max_frac = frac;
+                            val = static_cast<double>(fid.as_int());
+                        }
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+    void CoverageRasterWriter::end_window() {
+        if (m_window == nullptr) {
+            throw std::runtime_error("No coverage window has been started.");
+        }
+
+        write_window(*m_window);
+
+        m_window.reset();
+        m_max_coverage.reset();
+    }
+
+}
@@ -0,0 +1,80 @@
+// Copyright (c) 2021 ISciences, LLC.
+// All rights reserved.
+//
+// This software is licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License. You may
+// obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0.
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef EXACTEXTRACT_COVERAGE_RASTER_WRITER_H
+#define EXACTEXTRACT_COVERAGE_RASTER_WRITER_H
+
+#include <memory>
+#include <string>
+
+#include "feature_id.h"
+#include "grid.h"
+#include "raster.h"
+
+namespace exactextract {
+
+    /**
+     * Combines the coverage fractions of all features into a single raster,
+     * one window (subgrid) at a time, so that only the current window is
+     * held in memory.
+     */
+    class CoverageRasterWriter {
+    public:
+        enum class Method {
+            SUM,    ///< total fraction of each cell covered by any feature
+            MAX,    ///< largest fraction of each cell covered by a single feature
+            ARGMAX  ///< ID of the feature covering the largest fraction of each cell
+        };
+
+        /** Parse a method name ("sum", "max", or "argmax"). */
+        static Method parse_method(const std::string & name);
+
+        explicit CoverageRasterWriter(Method method) : m_method{method} {}
+
+        virtual ~CoverageRasterWriter() = default;
+
+        /** Start a window covering `grid`, which must not overlap a previous window. */
+        void begin_window(const Grid<bounded_extent> & grid);
+
+        /**
+         * Combine the coverage of feature `fid` into the current window. For
+         * the ARGMAX method, `fid` must be an integer no larger in magnitude
+         * than 2^53, so that it can be stored exactly.
+         */
+        void add(const FeatureId & fid, const Raster<float> & coverage);
+
+        /** Write the current window. */
+        void end_window();
+
+        virtual void finish() {}
+
+    protected:
+        /**
+         * Write a window of combined values. Cells not covered by any
+         * feature have a value of zero, or NaN for the ARGMAX method.
+         */
+        virtual void write_window(Raster<double> & window) = 0;
+
+        Method method() const {
+            return m_method;
+        }
+
+    private:
+        Method m_method;
+        std::unique_ptr<Raster<double>> m_window;
+        std::unique_ptr<Raster<float>> m_max_coverage;
+    };
+
+}
+
+#endif //EXACTEXTRACT_COVERAGE_RASTER_WRITER_H
@@ -0,0 +1,272 @@
+// Copyright (c) 2021 ISciences, LLC.
+// All rights reserved.
+//
+// This software is licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License. You may
+// obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0.
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "csv_writer.h"
+#include "gdal_dataset_wrapper.h"
+#include "stats_registry.h"
+#include "utils.h"
+
+#include "cpl_vsi.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <stdexcept>
+
+namespace exactextract {
+
+    static constexpr size_t BUFFER_SIZE = 1 << 20;
+
+    CSVFile::CSVFile(const std::string & filename) {
+        if (!handles(filename)) {
+            throw std::runtime_error("Unknown CSV output: " + filename);
+        }
+
+        std::string path = ends_with(filename, ".gz") ? "/vsigzip/" + filename : filename;
+
+        m_file = VSIFOpenL(path.c_str(), "wb");
+        if (m_file == nullptr) {
+            throw std::runtime_error("Could not create output: " + filename);
+        }
+
+        m_buf.reserve(BUFFER_SIZE + 4096);
+    }
+
+    CSVFile::~CSVFile() {
+        if (m_file != nullptr) {
+            // close() was not called, probably because of an error, so
+            // write whatever was buffered without throwing.
+            VSIFWriteL(m_buf.data(), 1, m_buf.size(), static_cast<VSILFILE*>(m_file));
+            VSIFCloseL(static_cast<VSILFILE*>(m_file));
+        }
+    }
+
+    bool CSVFile::handles(const std::string & filename) {
+        return ends_with(filename, ".csv") || ends_with(filename, ".csv.gz");
+    }
+
+    void CSVFile::write_string(const std::string & s) {
+        if (s.find_first_of(",\"\r\n") == std::string::npos) {
+            m_buf += s;
+            return;
+        }
+
+        m_buf += '"';
+        for (char c : s) {
+            if (c == '"') {
+                m_buf += '"';
+            }
+            m_buf += c;
+        }
+        m_buf += '"';
+    }
+
+    void CSVFile::write_int(long long val) {
+        m_buf += std::to_string(val);
+    }
+
+    void CSVFile::write_double(double val) {
+        if (std::isnan(val)) {
+            m_buf += "nan";
+            return;
+        }
+
+        // Integral values, such as counts and values of integer rasters,
+        // are common and can be written without a round trip through printf.
+        // Negative zero is left to printf so that its sign is kept.
+        if (std::abs(val) < 1e15 && val == std::trunc(val) && !(val == 0 && std::signbit(val))) {
+            write_int(static_cast<long long>(val));
+            return;
+        }
+
+        // Use the fewest significant digits that reproduce the value when
+        // read back.
+        char s[32];
+        for (int precision = 15; precision <= 17; precision++) {
+            std::snprintf(s, sizeof(s), "%.*g", precision, val);
+            if (precision == 17 || std::strtod(s, nullptr) == val) {
+                break;
+            }
+        }
+        m_buf += s;
+    }
+
+    void CSVFile::write_float(float val) {
+        char s[32];
+        for (int precision = 6; precision <= 9; precision++) {
+            std::snprintf(s, sizeof(s), "%.*g", precision, static_cast<double>(val));
+            if (precision == 9 || std::strtof(s, nullptr) == val) {
+                break;
+            }
+        }
+        m_buf += s;
+    }
+
+    void CSVFile::end_row() {
+        m_buf += '\n';
+
+        if (m_buf.size() >= BUFFER_SIZE) {
+            flush();
+        }
+    }
+
+    void CSVFile::close() {
+        if (m_file == nullptr) {
+            return;
+        }
+
+        flush();
+
+        auto file = static_cast<VSILFILE*>(m_file);
+        m_file = nullptr;
+        if (VSIFCloseL(file) != 0) {
+            throw std::runtime_error("Error closing CSV output.");
+        }
+    }
+
+    void CSVFile::flush() {
+        if (m_buf.empty()) {
+            return;
+        }
+
+        if (VSIFWriteL(m_buf.data(), 1, m_buf.size(), static_cast<VSILFILE*>(m_file)) != m_buf.size()) {
+            throw std::runtime_error("Error writing CSV output.");
+        }
+        m_buf.clear();
+    }
+
+    CSVWriter::CSVWriter(const std::string & filename) : m_file{filename}, m_reg{nullptr} {}
+
+    void CSVWriter::copy_id_field(const GDALDatasetWrapper & w) {
+        copy_id_field(w, w.id_field());
+    }
+
+    void CSVWriter::copy_id_field(const GDALDatasetWrapper &, const std::string & field_name) {
+        add_id_field(field_name, "");
+    }
+
+    void CSVWriter::add_id_field(const std::string & field_name, const std::string &) {
+        if (!m_id_field.empty()) {
+            throw std::runtime_error("ID field already defined.");
+        }
+
+        // Values are written according to the type of each FeatureId, so
+        // the declared type is not needed.
+        m_id_field = field_name;
+    }
+
+    void CSVWriter::add_operation(const Operation & op) {
+        if (m_id_field.empty()) {
+            throw std::runtime_error("Must define ID field before adding operations.");
+        }
+
+        m_ops.push_back(&op);
+    }
+
+    void CSVWriter::set_registry(const StatsRegistry* reg) {
+        m_reg = reg;
+    }
+
+    void CSVWriter::write(const FeatureId & fid) {
+        if (!m_header_written) {
+            write_header();
+        }
+
+        if (fid.is_int()) {
+            m_file.write_int(fid.as_int());
+        } else {
+            m_file.write_string(fid.as_string());
+        }
+
+        for (const auto &op : m_ops) {
+            m_file.write_separator();
+
+            // Leave the field empty for features without results, as is
+            // done for unset fields by the OGR CSV driver.
+            if (m_reg->contains(fid, *op)) {
+                auto val = op->result_fetcher()(m_reg->stats(fid, *op));
+                m_file.write_double(val.has_value() ? val.value() : std::numeric_limits<double>::quiet_NaN());
+            }
+        }
+
+        m_file.end_row();
+    }
+
+    void CSVWriter::finish() {
+        if (!m_header_written) {
+            write_header();
+        }
+
+        m_file.close();
+    }
+
+    void CSVWriter::write_header() {
+        m_file.write_string(m_id_field);
+        for (const auto &op : m_ops) {
+            m_file.write_separator();
+            m_file.write_string(op->name);
+        }
+        m_file.end_row();
+
+        m_header_written = true;
+    }
+
+    CSVCellWriter::CSVCellWriter(const std::string & filename, const std::string & id_field) : m_file{filename} {
+        m_file.write_string(id_field);
+        for (const char* field : {"raster", "row", "col", "coverage_fraction", "value", "weight"}) {
+            m_file.write_separator();
+            m_file.write_string(field);
+        }
+        m_file.end_row();
+    }
+
+    void CSVCellWriter::finish() {
+        m_file.close();
+    }
+
+    void CSVCellWriter::write_cell(const FeatureId & fid,
+                                   const Operation & op,
+                                   size_t row,
+                                   size_t col,
+                                   float coverage,
+                                   double value,
+                                   double weight) {
+        if (fid.is_int()) {
+            m_file.write_int(fid.as_int());
+        } else {
+            m_file.write_string(fid.as_string());
+        }
+        m_file.write_separator();
+        m_file.write_string(op.values->name());
+        m_file.write_separator();
+        m_file.write_int(static_cast<long long>(row));
+        m_file.write_separator();
+        m_file.write_int(static_cast<long long>(col));
+        m_file.write_separator();
+        m_file.write_float(coverage);
+
+        // Leave fields empty where there is no value or weight.
+        m_file.write_separator();
+        if (!std::isnan(value)) {
+            m_file.write_double(value);
+        }
+        m_file.write_separator();
+        if (!std::isnan(weight)) {
+            m_file.write_double(weight);
+        }
+
+        m_file.end_row();
+    }
+
+}
@@ -0,0 +1,130 @@
+// Copyright (c) 2021 ISciences, LLC.
+// All rights reserved.
+//
+// This software is licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License. You may
+// obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0.
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef EXACTEXTRACT_CSV_WRITER_H
+#define EXACTEXTRACT_CSV_WRITER_H
+
+#include "cell_writer.h"
+#include "output_writer.h"
+
+#include <string>
+
+namespace exactextract {
+
+    class GDALDatasetWrapper;
+
+    /**
+     * A CSV file to which rows are formatted into a buffer that is written
+     * in large blocks. A filename ending in `.gz` is compressed as it is
+     * written.
+     */
+    class CSVFile {
+    public:
+        explicit CSVFile(const std::string & filename);
+
+        ~CSVFile();
+
+        /** Return true if `filename` names an output that can be written as CSV. */
+        static bool handles(const std::string & filename);
+
+        void write_string(const std::string & s);
+
+        void write_int(long long val);
+
+        /** Write a value with the fewest digits that reproduce it when read. */
+        void write_double(double val);
+
+        void write_float(float val);
+
+        void write_separator() {
+            m_buf += ',';
+        }
+
+        void end_row();
+
+        /** Write any buffered rows and close the file. */
+        void close();
+
+    private:
+        using VSILFILEH = void*;
+
+        void flush();
+
+        VSILFILEH m_file;
+        std::string m_buf;
+    };
+
+    /**
+     * Writes results to a CSV file without going through an OGR driver.
+     */
+    class CSVWriter : public OutputWriter {
+
+    public:
+        explicit CSVWriter(const std::string & filename);
+
+        /** Return true if `filename` names an output that can be written by a CSVWriter. */
+        static bool handles(const std::string & filename) {
+            return CSVFile::handles(filename);
+        }
+
+        void add_operation(const Operation & op) override;
+
+        void set_registry(const StatsRegistry* reg) override;
+
+        void write(const FeatureId & fid) override;
+
+        void finish() override;
+
+        void add_id_field(const std::string & field_name, const std::string & field_type);
+
+        void copy_id_field(const GDALDatasetWrapper & w);
+
+        /** Define the ID field with the name of the field `field_name` of `w`. */
+        void copy_id_field(const GDALDatasetWrapper & w, const std::string & field_name);
+
+    private:
+        void write_header();
+
+        CSVFile m_file;
+        const StatsRegistry* m_reg;
+        std::string m_id_field;
+        bool m_header_written = false;
+    };
+
+    /**
+     * Writes the cells covered by each feature to a CSV file, with columns
+     * for the feature ID, the name of the value raster, the row and column
+     * of the cell, its coverage fraction, and its value and weight.
+     */
+    class CSVCellWriter : public CellWriter {
+    public:
+        CSVCellWriter(const std::string & filename, const std::string & id_field);
+
+        void finish() override;
+
+    protected:
+        void write_cell(const FeatureId & fid,
+                        const Operation & op,
+                        size_t row,
+                        size_t col,
+                        float coverage,
+                        double value,
+                        double weight) override;
+
+    private:
+        CSVFile m_file;
+    };
+
+}
+
+#endif //EXACTEXTRACT_CSV_WRITER_H
@@ -11,6 +11,7 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
 #include <exception>
 #include <iostream>
 #include <memory>
@@ -19,40 +20,90 @@
 
 #include "CLI11.hpp"
 
+#include "async_writer.h"
+#include "csv_writer.h"
+#include "gdal_coverage_raster_writer.h"
 #include "gdal_dataset_wrapper.h"
 #include "gdal_raster_wrapper.h"
 #include "gdal_writer.h"
 #include "operation.h"
 #include "processor.h"
 #include "feature_sequential_processor.h"
+#include "raster_area_source.h"
 #include "raster_sequential_processor.h"
+#include "resampled_raster_source.h"
+#include "rollup_writer.h"
+#include "strategy.h"
 #include "utils.h"
 #include "version.h"
 
 using exactextract::GDALDatasetWrapper;
 using exactextract::GDALRasterWrapper;
 using exactextract::Operation;
+using exactextract::RasterSource;
 
 static GDALDatasetWrapper load_dataset(const std::string & descriptor, const std::string & field_name);
-static std::unordered_map<std::string, GDALRasterWrapper> load_rasters(const std::vector<std::string> & descriptors);
+static std::unique_ptr<exactextract::OutputWriter> create_writer(const std::string & filename,
+                                                                 size_t batch_size,
+                                                                 bool single_precision,
+                                                                 const GDALDatasetWrapper & layer,
+                                                                 const std::string & field_name,
+                                                                 const std::string & id_name,
+                                                                 const std::string & id_type);
+static std::unordered_map<std::string, GDALRasterWrapper> load_rasters(const std::vector<std::string> & descriptors, size_t read_threads);
+static std::unordered_map<std::string, RasterSource*> prepare_sources(const std::vector<std::string> & descriptors,
+        std::unordered_map<std::string, GDALRasterWrapper> & rasters,
+        const std::string & resample_method,
+        std::vector<std::unique_ptr<RasterSource>> & derived_sources);
 static std::vector<Operation> prepare_operations(const std::vector<std::string> & descriptors,
-        std::unordered_map<std::string, GDALRasterWrapper> & rasters);
+        std::unordered_map<std::string, RasterSource*> & sources);
+static std::string select_strategy(std::vector<GDALDatasetWrapper> & layers,
+        const std::unordered_map<std::string, GDALRasterWrapper> & rasters,
+        const std::vector<Operation> & operations,
+        size_t max_cells_in_memory);
 
 int main(int argc, char** argv) {
     CLI::App app{"Zonal statistics using exactextract: build " + exactextract::version()};
 
-    std::string poly_descriptor, field_name, output_filename, strategy, id_type, id_name;
+    std::string strategy, id_type, id_name, resample_method, feature_order, spill_dir;
     std::vector<std::string> stats;
     std::vector<std::string> raster_descriptors;
+    std::vector<std::string> poly_descriptors, field_names, output_filenames;
+    std::vector<std::string> rollups;
+    std::string cell_output;
+    std::string coverage_output, coverage_method;
     size_t max_cells_in_memory = 30;
+    size_t read_threads = 1;
+    size_t batch_size = 10000;
     bool progress;
-    app.add_option("-p,--polygons", poly_descriptor, "polygon dataset")->required(true);
+    bool preserve_order = false;
+    bool spatial_filter = false;
+    bool shared_edges = false;
+    bool lazy_geometry = false;
+    bool async_write = false;
+    bool single_precision = false;
+    app.add_option("-p,--polygons", poly_descriptors, "polygon dataset")->required(true);
     app.add_option("-r,--raster", raster_descriptors, "raster dataset")->required(true);
-    app.add_option("-f,--fid", field_name, "id from polygon dataset to retain in output")->required(true);
-    app.add_option("-o,--output", output_filename, "output filename")->required(true);
+    app.add_option("-f,--fid", field_names, "id from polygon dataset to retain in output")->required(true);
+    app.add_option("-o,--output", output_filenames, "output filename")->required(true);
     app.add_option("-s,--stat", stats, "statistics")->required(true)->expected(-1);
     app.add_option("--max-cells", max_cells_in_memory, "maximum number of raster cells to read in memory at once, in millions")->required(false)->default_val("30");
-    app.add_option("--strategy", strategy, "processing strategy")->required(false)->default_val("feature-sequential");
+    app.add_option("--read-threads", read_threads, "number of threads used to decode blocks within a single raster read")->required(false)->default_val("1");
+    app.add_option("--batch-size", batch_size, "number of features to write in each transaction, for output formats that support transactions")->required(false)->default_val("10000");
+    app.add_flag("--single-precision", single_precision, "store results as single-precision floating-point values, for output formats that support them");
+    app.add_flag("--async-write", async_write, "write results on a separate thread, so that processing is not slowed by the output");
+    app.add_option("--resample", resample_method, "resample rasters not aligned with the first raster (nearest, average)")->required(false);
+    app.add_option("--strategy", strategy, "processing strategy (feature-sequential, raster-sequential, auto)")->required(false)->default_val("feature-sequential");
+    app.add_option("--spill-dir", spill_dir, "directory for temporary files used to hold features out of memory with the raster-sequential strategy")->required(false);
+    app.add_option("--feature-order", feature_order, "order in which to process features (source, hilbert)")->required(false)->default_val("source");
+    app.add_flag("--shared-edges", shared_edges, "with the raster-sequential strategy, compute coverage of polygons that share edges together");
+    app.add_flag("--lazy-geometry", lazy_geometry, "with the raster-sequential strategy, read polygons when first needed instead of holding all of them in memory");
+    app.add_flag("--preserve-order", preserve_order, "write results in source order when processing features in a different order");
+    app.add_option("--cell-output", cell_output, "also write each cell covered by each polygon, with its coverage fraction and values, to a CSV file")->required(false);
+    app.add_option("--coverage-output", coverage_output, "also write a GeoTIFF combining the coverage fractions of all polygons, using the raster-sequential strategy")->required(false);
+    app.add_option("--coverage-method", coverage_method, "method used to combine coverage fractions in the coverage output (sum, max, argmax)")->required(false)->default_val("sum");
+    app.add_option("--roll-up", rollups, "also summarize groups of polygons by combining their results, given as PARENT_FIELD:OUTPUT")->required(false);
+    app.add_flag("--skip-outside-extent", spatial_filter, "do not read or write features that fall outside the extent of the rasters");
     app.add_option("--id-type", id_type, "override type of id field in output")->required(false);
     app.add_option("--id-name", id_name, "override name of id field in output")->required(false);
     app.add_flag("--progress", progress);
@@ -69,41 +120,219 @@ int main(int argc, char** argv) {
         return 1;
     }
 
+    if (output_filenames.size() != poly_descriptors.size()) {
+        std::cerr << "Must specify one output filename for each polygon dataset" << std::endl;
+        return 1;
+    }
+
+    if (field_names.size() != 1 && field_names.size() != poly_descriptors.size()) {
+        std::cerr << "Must specify a single id field, or one for each polygon dataset" << std::endl;
+        return 1;
+    }
+
+    if (!cell_output.empty() && poly_descriptors.size() > 1) {
+        std::cerr << "Cell output is only supported with a single polygon dataset" << std::endl;
+        return 1;
+    }
+
+    if (!coverage_output.empty() && poly_descriptors.size() > 1) {
+        std::cerr << "Coverage output is only supported with a single polygon dataset" << std::endl;
+        return 1;
+    }
+
+    if (!rollups.empty() && poly_descriptors.size() > 1) {
+        std::cerr << "Roll-up is only supported with a single polygon dataset" << std::endl;
+        return 1;
+    }
+
     max_cells_in_memory *= 1000000;
 
-    std::unique_ptr<exactextract::Processor> proc;
-    std::unique_ptr<exactextract::OutputWriter> writer;
+    std::vector<std::unique_ptr<exactextract::Processor>> procs;
+    std::vector<std::unique_ptr<exactextract::OutputWriter>> writers;
+    // Declared after the writers they wrap, so that their threads are
+    // stopped before the wrapped writers are destroyed.
+    std::vector<std::unique_ptr<exactextract::AsyncWriter>> async_writers;
+    std::vector<exactextract::OutputWriter*> outputs;
 
     try {
         GDALAllRegister();
 
-        auto rasters = load_rasters(raster_descriptors);
+        auto rasters = load_rasters(raster_descriptors, read_threads);
 
-        GDALDatasetWrapper shp = load_dataset(poly_descriptor, field_name);
+        std::vector<std::unique_ptr<RasterSource>> derived_sources;
+        auto sources = prepare_sources(raster_descriptors, rasters, resample_method, derived_sources);
 
-        auto gdal_writer = std::make_unique<exactextract::GDALWriter>(output_filename);
-        if (!id_name.empty() && !id_type.empty()) {
-            gdal_writer->add_id_field(id_name, id_type);
-        } else {
-            gdal_writer->copy_id_field(shp);
+        std::vector<GDALDatasetWrapper> layers;
+        layers.reserve(poly_descriptors.size());
+
+        for (size_t i = 0; i < poly_descriptors.size(); i++) {
+            layers.push_back(load_dataset(poly_descriptors[i], field_names[field_names.size() == 1 ? 0 : i]));
+
+            writers.push_back(create_writer(output_filenames[i], batch_size, single_precision, layers.back(), layers.back().id_field(), id_name, id_type));
+            outputs.push_back(writers.back().get());
+        }
+
+        for (const auto& rollup : rollups) {
+            auto sep = rollup.find(':');
+            if (sep == std::string::npos) {
+                throw std::runtime_error("Roll-up must be specified as PARENT_FIELD:OUTPUT, got " + rollup);
+            }
+            auto parent_field = rollup.substr(0, sep);
+
+            auto parent_writer = create_writer(rollup.substr(sep + 1), batch_size, single_precision, layers[0], parent_field, "", "");
+
+            // Each level is combined from the finest level, so that the
+            // parent field of every level is read from the same layer.
+            auto rollup_writer = std::make_unique<exactextract::RollupWriter>(*outputs[0], *parent_writer, layers[0].read_parent_ids(parent_field));
+            outputs[0] = rollup_writer.get();
+
+            writers.push_back(std::move(parent_writer));
+            writers.push_back(std::move(rollup_writer));
+        }
+
+        std::unique_ptr<exactextract::CSVCellWriter> cell_writer;
+        if (!cell_output.empty()) {
+            cell_writer = std::make_unique<exactextract::CSVCellWriter>(cell_output, id_name.empty() ? layers[0].id_field() : id_name);
+        }
+
+        if (async_write) {
+            for (auto& output : outputs) {
+                async_writers.push_back(std::make_unique<exactextract::AsyncWriter>(*output));
+                output = async_writers.back().get();
+            }
         }
-        writer = std::move(gdal_writer);
 
-        auto operations = prepare_operations(stats, rasters);
+        auto operations = prepare_operations(stats, sources);
+
+        if (spatial_filter) {
+            for (auto& shp : layers) {
+                shp.set_spatial_filter(exactextract::common_grid(operations.begin(), operations.end()).extent());
+            }
+        }
+
+        if (feature_order != "source" && feature_order != "hilbert") {
+            throw std::runtime_error("Unknown feature order: " + feature_order);
+        }
+
+        // Some options are only supported by one strategy, which then
+        // determines the strategy chosen by "auto".
+        std::string raster_sequential_option;
+        if (!spill_dir.empty()) {
+            raster_sequential_option = "--spill-dir";
+        } else if (shared_edges) {
+            raster_sequential_option = "--shared-edges";
+        } else if (!coverage_output.empty()) {
+            raster_sequential_option = "--coverage-output";
+        } else if (lazy_geometry) {
+            raster_sequential_option = "--lazy-geometry";
+        }
+
+        std::string feature_sequential_option;
+        if (feature_order != "source") {
+            feature_sequential_option = "--feature-order";
+        } else if (preserve_order) {
+            feature_sequential_option = "--preserve-order";
+        }
+
+        if (strategy == "auto") {
+            if (!raster_sequential_option.empty() && !feature_sequential_option.empty()) {
+                throw std::runtime_error(raster_sequential_option + " requires the raster-sequential strategy, but " +
+                                         feature_sequential_option + " requires the feature-sequential strategy.");
+            } else if (!raster_sequential_option.empty()) {
+                strategy = "raster-sequential";
+                std::cerr << "Using raster-sequential strategy, as required by " << raster_sequential_option << std::endl;
+            } else if (!feature_sequential_option.empty()) {
+                strategy = "feature-sequential";
+                std::cerr << "Using feature-sequential strategy, as required by " << feature_sequential_option << std::endl;
+            } else {
+                strategy = select_strategy(layers, rasters, operations, max_cells_in_memory);
+            }
+        }
+
+        std::unique_ptr<exactextract::GDALCoverageRasterWriter> coverage_writer;
+        if (!coverage_output.empty()) {
+            if (strategy != "raster-sequential") {
+                throw std::runtime_error("Coverage output can only be written with the raster-sequential strategy.");
+            }
+
+            // Use the projection of the first raster given, to which the
+            // others are aligned.
+            std::string projection;
+            for (const auto& descriptor : raster_descriptors) {
+                auto it = rasters.find(std::get<0>(exactextract::parse_raster_descriptor(descriptor)));
+                if (it != rasters.end()) {
+                    projection = it->second.projection();
+                    break;
+                }
+            }
+
+            coverage_writer = std::make_unique<exactextract::GDALCoverageRasterWriter>(
+                    coverage_output,
+                    exactextract::CoverageRasterWriter::parse_method(coverage_method),
+                    exactextract::common_grid(operations.begin(), operations.end()),
+                    projection);
+        }
 
         if (strategy == "feature-sequential") {
-            proc = std::make_unique<exactextract::FeatureSequentialProcessor>(shp, *writer, operations);
+            if (!spill_dir.empty()) {
+                throw std::runtime_error("A spill directory can only be specified with the raster-sequential strategy.");
+            }
+            if (shared_edges) {
+                throw std::runtime_error("Shared edges can only be used with the raster-sequential strategy.");
+            }
+            if (lazy_geometry) {
+                throw std::runtime_error("Lazy geometry can only be used with the raster-sequential strategy.");
+            }
+            if (preserve_order && feature_order == "source") {
+                throw std::runtime_error("Preserving order has no effect unless features are processed in a different order.");
+            }
+            // Each layer is processed in turn.
+            for (size_t i = 0; i < layers.size(); i++) {
+                auto fsp = std::make_unique<exactextract::FeatureSequentialProcessor>(layers[i], *outputs[i], operations);
+                fsp->set_hilbert_order(feature_order == "hilbert");
+                fsp->set_preserve_order(preserve_order);
+                procs.push_back(std::move(fsp));
+            }
         } else if (strategy == "raster-sequential") {
-            proc = std::make_unique<exactextract::RasterSequentialProcessor>(shp, *writer, operations);
+            if (feature_order != "source") {
+                throw std::runtime_error("Feature order can only be specified with the feature-sequential strategy.");
+            }
+            if (preserve_order) {
+                throw std::runtime_error("Preserving order can only be specified with the feature-sequential strategy.");
+            }
+            // All layers are processed together, in a single pass over the rasters.
+            auto rsp = std::make_unique<exactextract::RasterSequentialProcessor>(layers[0], *outputs[0], operations);
+            for (size_t i = 1; i < layers.size(); i++) {
+                rsp->add_layer(layers[i], *outputs[i]);
+            }
+            rsp->set_spill_dir(spill_dir);
+            rsp->set_shared_edges(shared_edges);
+            rsp->set_lazy_geometry(lazy_geometry);
+            rsp->set_coverage_raster_writer(coverage_writer.get());
+            procs.push_back(std::move(rsp));
         } else {
             throw std::runtime_error("Unknown processing strategy: " + strategy);
         }
 
-        proc->set_max_cells_in_memory(max_cells_in_memory);
-        proc->show_progress(progress);
+        for (auto& proc : procs) {
+            proc->set_max_cells_in_memory(max_cells_in_memory);
+            proc->show_progress(progress);
+            proc->set_cell_writer(cell_writer.get());
+
+            proc->process();
+        }
+
+        for (auto& output : outputs) {
+            output->finish();
+        }
+
+        if (cell_writer) {
+            cell_writer->finish();
+        }
 
-        proc->process();
-        writer->finish();
+        if (coverage_writer) {
+            coverage_writer->finish();
+        }
 
         return 0;
     } catch (const std::exception & e) {
@@ -117,13 +346,50 @@ int main(int argc, char** argv) {
     }
 }
 
+static bool is_virtual_raster(const std::string & filename) {
+    return exactextract::starts_with(filename, "@");
+}
+
 static GDALDatasetWrapper load_dataset(const std::string & descriptor, const std::string & field_name) {
     auto parsed = exactextract::parse_dataset_descriptor(descriptor);
 
     return GDALDatasetWrapper{parsed.first, parsed.second, field_name};
 }
 
-static std::unordered_map<std::string, GDALRasterWrapper> load_rasters(const std::vector<std::string> & descriptors) {
+template<typename Writer>
+static void define_id_field(Writer & writer,
+                            const GDALDatasetWrapper & layer,
+                            const std::string & field_name,
+                            const std::string & id_name,
+                            const std::string & id_type) {
+    if (!id_name.empty() && !id_type.empty()) {
+        writer.add_id_field(id_name, id_type);
+    } else {
+        writer.copy_id_field(layer, field_name);
+    }
+}
+
+static std::unique_ptr<exactextract::OutputWriter> create_writer(const std::string & filename,
+                                                                 size_t batch_size,
+                                                                 bool single_precision,
+                                                                 const GDALDatasetWrapper & layer,
+                                                                 const std::string & field_name,
+                                                                 const std::string & id_name,
+                                                                 const std::string & id_type) {
+    if (exactextract::CSVWriter::handles(filename)) {
+        auto csv_writer = std::make_unique<exactextract::CSVWriter>(filename);
+        define_id_field(*csv_writer, layer, field_name, id_name, id_type);
+        return csv_writer;
+    }
+
+    auto gdal_writer = std::make_unique<exactextract::GDALWriter>(filename);
+    gdal_writer->set_batch_size(batch_size);
+    gdal_writer->set_single_precision(single_precision);
+    define_id_field(*gdal_writer, layer, field_name, id_name, id_type);
+    return gdal_writer;
+}
+
+static std::unordered_map<std::string, GDALRasterWrapper> load_rasters(const std::vector<std::string> & descriptors, size_t read_threads) {
     std::unordered_map<std::string, GDALRasterWrapper> rasters;
 
     for (const auto &descriptor : descriptors) {
@@ -131,37 +397,100 @@ static std::unordered_map<std::string, GDALRasterWrapper> load_rasters(const std
 
         auto name = std::get<0>(parsed);
 
+        if (is_virtual_raster(std::get<1>(parsed))) {
+            continue;
+        }
+
         rasters.emplace(name, GDALRasterWrapper{std::get<1>(parsed), std::get<2>(parsed)});
         rasters.at(name).set_name(name);
+        rasters.at(name).set_read_threads(read_threads);
     }
 
     return rasters;
 }
 
+static std::unordered_map<std::string, RasterSource*> prepare_sources(const std::vector<std::string> & descriptors,
+        std::unordered_map<std::string, GDALRasterWrapper> & rasters,
+        const std::string & resample_method,
+        std::vector<std::unique_ptr<RasterSource>> & derived_sources) {
+    std::unordered_map<std::string, RasterSource*> sources;
+
+    auto target = exactextract::Grid<exactextract::bounded_extent>::make_empty();
+
+    for (const auto &descriptor : descriptors) {
+        auto name = std::get<0>(exactextract::parse_raster_descriptor(descriptor));
+        auto it = rasters.find(name);
+        if (it == rasters.end()) {
+            continue;
+        }
+        auto& raster = it->second;
+
+        if (target.empty()) {
+            target = raster.grid();
+        }
+
+        if (resample_method.empty() || raster.grid().compatible_with(target)) {
+            sources[name] = &raster;
+        } else {
+            // Present this raster on the grid of the first raster, so that the two can be used together
+            derived_sources.push_back(std::make_unique<exactextract::ResampledRasterSource>(
+                    raster, target, exactextract::parse_resample_method(resample_method)));
+            sources[name] = derived_sources.back().get();
+        }
+    }
+
+    // Virtual rasters such as @spherical_area are defined on the common grid of the other rasters.
+    for (const auto &descriptor : descriptors) {
+        auto parsed = exactextract::parse_raster_descriptor(descriptor);
+        auto name = std::get<0>(parsed);
+        auto filename = std::get<1>(parsed);
+
+        if (!is_virtual_raster(filename)) {
+            continue;
+        }
+
+        auto grid = exactextract::Grid<exactextract::bounded_extent>::make_empty();
+        for (const auto& source : sources) {
+            grid = grid.empty() ? source.second->grid() : grid.common_grid(source.second->grid());
+        }
+
+        if (grid.empty()) {
+            throw std::runtime_error("Virtual raster " + filename + " requires at least one other raster.");
+        }
+
+        derived_sources.push_back(std::make_unique<exactextract::AreaRasterSource>(
+                grid, exactextract::AreaRasterSource::parse_method(filename.substr(1))));
+        derived_sources.back()->set_name(name);
+        sources[name] = derived_sources.back().get();
+    }
+
+    return sources;
+}
+
 static std::vector<Operation> prepare_operations(const std::vector<std::string> & descriptors,
-        std::unordered_map<std::string, GDALRasterWrapper> & rasters) {
+        std::unordered_map<std::string, RasterSource*> & sources) {
     std::vector<Operation> ops;
 
     for (const auto &descriptor : descriptors) {
         auto stat = exactextract::parse_stat_descriptor(descriptor);
 
-        auto values_it = rasters.find(stat.values);
-        if (values_it == rasters.end()) {
+        auto values_it = sources.find(stat.values);
+        if (values_it == sources.end()) {
             throw std::runtime_error("Unknown raster " + stat.values + " in stat descriptor: " + descriptor);
         }
 
-        GDALRasterWrapper* values = &(values_it->second);
-        GDALRasterWrapper* weights;
+        RasterSource* values = values_it->second;
+        RasterSource* weights;
 
         if (stat.weights.empty()) {
             weights = nullptr;
         } else {
-            auto weights_it = rasters.find(stat.weights);
-            if (weights_it == rasters.end()) {
+            auto weights_it = sources.find(stat.weights);
+            if (weights_it == sources.end()) {
                 throw std::runtime_error("Unknown raster " + stat.weights + " in stat descriptor: " + descriptor);
             }
 
-            weights = &(weights_it->second);
+            weights = weights_it->second;
         }
 
         ops.emplace_back(stat.stat, stat.name, values, weights);
@@ -169,3 +498,77 @@ static std::vector<Operation> prepare_operations(const std::vector<std::string>
 
     return ops;
 }
+
+static std::string select_strategy(std::vector<GDALDatasetWrapper> & layers,
+        const std::unordered_map<std::string, GDALRasterWrapper> & rasters,
+        const std::vector<Operation> & operations,
+        size_t max_cells_in_memory) {
+    constexpr size_t max_samples = 1000;
+
+    size_t block_rows = 1;
+    size_t block_cols = 1;
+    for (const auto& raster : rasters) {
+        auto block_size = raster.second.block_size();
+        block_rows = std::max(block_rows, block_size.first);
+        block_cols = std::max(block_cols, block_size.second);
+    }
+
+    auto grid = exactextract::common_grid(operations.begin(), operations.end());
+
+    // Feature-sequential processing reads the rasters once for each layer,
+    // while raster-sequential processing reads them once for all layers.
+    exactextract::StrategyEstimate est{};
+    std::string sample_note;
+    for (auto& shp : layers) {
+        // Only the first features are sampled, which may be unrepresentative
+        // of a spatially sorted layer, so this is noted in the output.
+        std::vector<exactextract::Box> envelopes;
+        bool more = false;
+        while (shp.next()) {
+            if (envelopes.size() == max_samples) {
+                more = true;
+                break;
+            }
+            envelopes.push_back(shp.feature_envelope());
+        }
+        shp.reset();
+
+        // The count is not forced, because some drivers would need to read
+        // every feature to provide it. If it is not known, the sample size is
+        // used as a lower bound.
+        auto num_features = shp.feature_count();
+        if (num_features < 0 || !more) {
+            num_features = static_cast<GIntBig>(envelopes.size());
+        }
+
+        if (more) {
+            sample_note = "; estimated from the first " + std::to_string(max_samples) + " features of each layer";
+            if (shp.feature_count() < 0) {
+                sample_note += ", counting only the sampled features of layers whose size is unknown";
+            }
+        }
+
+        auto layer_est = exactextract::choose_strategy(grid,
+                                                       shp.extent(),
+                                                       envelopes,
+                                                       static_cast<size_t>(num_features),
+                                                       block_rows,
+                                                       block_cols,
+                                                       max_cells_in_memory);
+
+        est.feature_sequential_cells += layer_est.feature_sequential_cells;
+        if (layer_est.raster_sequential_cells > est.raster_sequential_cells) {
+            est.raster_sequential_cells = layer_est.raster_sequential_cells;
+            est.num_subgrids = layer_est.num_subgrids;
+        }
+    }
+
+    est.strategy = est.raster_sequential_cells < est.feature_sequential_cells ? "raster-sequential" : "feature-sequential";
+
+    std::cerr << "Using " << est.strategy << " strategy (estimated cells read: "
+              << est.feature_sequential_cells << " feature-sequential, "
+              << est.raster_sequential_cells << " raster-sequential in "
+              << est.num_subgrids << " subgrids" << sample_note << ")" << std::endl;
+
+    return est.strategy;
+}
@@ -0,0 +1,94 @@
+// Copyright (c) 2020 ISciences, LLC.
+// All rights reserved.
+//
+// This software is licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License. You may
+// obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0.
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef EXACTEXTRACT_FEATURE_ID_H
+#define EXACTEXTRACT_FEATURE_ID_H
+
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <string>
+
+namespace exactextract {
+
+    /**
+     * The identifier of a feature, which is stored as an integer when the
+     * source field is an integer and as a string otherwise. Integer and string
+     * identifiers never compare equal, even if the string is the decimal
+     * representation of the integer.
+     */
+    class FeatureId {
+    public:
+        FeatureId() : m_int{0}, m_is_int{true} {}
+
+        FeatureId(int64_t id) : m_int{id}, m_is_int{true} {}
+
+        FeatureId(std::string id) : m_int{0}, m_str{std::move(id)}, m_is_int{false} {}
+
+        FeatureId(const char* id) : FeatureId(std::string(id)) {}
+
+        bool is_int() const {
+            return m_is_int;
+        }
+
+        int64_t as_int() const {
+            return m_int;
+        }
+
+        /** Return the string value of a string identifier. */
+        const std::string& as_string() const {
+            return m_str;
+        }
+
+        /** Format the identifier as a string, regardless of its type. */
+        std::string to_string() const {
+            return m_is_int ? std::to_string(m_int) : m_str;
+        }
+
+        bool operator==(const FeatureId & other) const {
+            return m_is_int == other.m_is_int && m_int == other.m_int && m_str == other.m_str;
+        }
+
+        bool operator!=(const FeatureId & other) const {
+            return !(*this == other);
+        }
+
+        size_t hash() const {
+            return m_is_int ? std::hash<int64_t>{}(m_int) : std::hash<std::string>{}(m_str);
+        }
+
+    private:
+        int64_t m_int;
+        std::string m_str;
+        bool m_is_int;
+    };
+
+    inline std::ostream& operator<<(std::ostream & os, const FeatureId & id) {
+        if (id.is_int()) {
+            return os << id.as_int();
+        }
+        return os << id.as_string();
+    }
+
+}
+
+namespace std {
+    template<>
+    struct hash<exactextract::FeatureId> {
+        size_t operator()(const exactextract::FeatureId & id) const {
+            return id.hash();
+        }
+    };
+}
+
+#endif
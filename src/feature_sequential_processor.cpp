@@ -12,12 +12,14 @@
 // limitations under the License.
 
 #include <set>
+#include <stdexcept>
 #include <string>
 
 #include "box.h"
 #include "feature_sequential_processor.h"
-#include "geos_utils.h"
+#include "flat_geometry.h"
 #include "grid.h"
+#include "hilbert.h"
 
 namespace exactextract {
 
@@ -26,67 +28,133 @@ namespace exactextract {
             m_output.add_operation(op);
         }
 
+        if (m_hilbert_order) {
+            process_in_hilbert_order();
+            return;
+        }
+
+        while (m_shp.next()) {
+            FeatureId name = m_shp.feature_id();
+            m_shp.feature_geometry(m_geometry);
+
+            process_feature(name, m_geometry);
+
+            m_output.write(name);
+            m_reg.flush_feature(name);
+        }
+    }
+
+    void FeatureSequentialProcessor::process_in_hilbert_order() {
+        if (!m_shp.supports_random_read()) {
+            throw std::runtime_error("Processing features in Hilbert order requires a layer that supports random reads.");
+        }
+
+        // Scan envelopes only, without converting geometries to GEOS
+        std::vector<GIntBig> fids;
+        std::vector<Box> envelopes;
         while (m_shp.next()) {
-            std::string name{m_shp.feature_field(m_shp.id_field())};
-            auto geom = geos_ptr(m_geos_context, m_shp.feature_geometry(m_geos_context));
+            fids.push_back(m_shp.feature_fid());
+            envelopes.push_back(m_shp.feature_envelope());
+        }
+        m_shp.reset();
+
+        auto order = hilbert_order(envelopes);
+        envelopes.clear();
+        envelopes.shrink_to_fit();
+
+        std::vector<FeatureId> names(m_preserve_order ? fids.size() : 0);
+        std::vector<bool> done(m_preserve_order ? fids.size() : 0, false);
+        size_t next_to_write = 0;
+
+        for (size_t i : order) {
+            if (!m_shp.seek(fids[i])) {
+                throw std::runtime_error("Failed to read feature with FID " + std::to_string(fids[i]));
+            }
+
+            FeatureId name = m_shp.feature_id();
+            m_shp.feature_geometry(m_geometry);
 
-            progress(name);
+            process_feature(name, m_geometry);
 
-            Box feature_bbox = exactextract::geos_get_box(m_geos_context, geom.get());
+            if (m_preserve_order) {
+                names[i] = std::move(name);
+                done[i] = true;
 
-            auto grid = common_grid(m_operations.begin(), m_operations.end());
+                for (; next_to_write < done.size() && done[next_to_write]; next_to_write++) {
+                    m_output.write(names[next_to_write]);
+                    m_reg.flush_feature(names[next_to_write]);
+                    names[next_to_write] = FeatureId{};
+                }
+            } else {
+                m_output.write(name);
+                m_reg.flush_feature(name);
+            }
+        }
+    }
+
+    void FeatureSequentialProcessor::process_feature(const FeatureId & name, const FlatGeometry & geom) {
+        progress(name);
+
+        if (geom.empty()) {
+            return;
+        }
+
+        Box feature_bbox = geom.box();
+
+        auto grid = common_grid(m_operations.begin(), m_operations.end());
 
-            if (feature_bbox.intersects(grid.extent())) {
-                // Crop grid to portion overlapping feature
-                auto cropped_grid = grid.crop(feature_bbox);
+        if (feature_bbox.intersects(grid.extent())) {
+            // Crop grid to portion overlapping feature
+            auto cropped_grid = grid.crop(feature_bbox);
 
-                for (const auto &subgrid : subdivide(cropped_grid, m_max_cells_in_memory)) {
-                    std::unique_ptr<Raster<float>> coverage;
+            for (const auto &subgrid : subdivide(cropped_grid, m_max_cells_in_memory)) {
+                std::unique_ptr<Raster<float>> coverage;
 
-                    std::set<std::pair<RasterSource*, RasterSource*>> processed;
+                std::set<std::pair<RasterSource*, RasterSource*>> processed;
 
-                    for (const auto &op : m_operations) {
-                        // TODO avoid reading same values/weights multiple times. Just use a map?
+                for (const auto &op : m_operations) {
+                    // TODO avoid reading same values/weights multiple times. Just use a map?
 
-                        // Avoid processing same values/weights for different stats
-                        auto key = std::make_pair(op.weights, op.values);
-                        if (processed.find(key) != processed.end()) {
-                            continue;
-                        } else {
-                            processed.insert(key);
-                        }
+                    // Avoid processing same values/weights for different stats
+                    auto key = std::make_pair(op.weights, op.values);
+                    if (processed.find(key) != processed.end()) {
+                        continue;
+                    } else {
+                        processed.insert(key);
+                    }
 
-                        if (!op.values->grid().extent().contains(subgrid.extent())) {
-                            continue;
-                        }
+                    if (!op.values->grid().extent().contains(subgrid.extent())) {
+                        continue;
+                    }
 
-                        if (op.weighted() && !op.weights->grid().extent().contains(subgrid.extent())) {
-                            continue;
-                        }
+                    if (op.weighted() && !op.weights->grid().extent().contains(subgrid.extent())) {
+                        continue;
+                    }
 
-                        // Lazy-initialize coverage
-                        if (coverage == nullptr) {
-                            coverage = std::make_unique<Raster<float>>(
-                                    raster_cell_intersection(subgrid, m_geos_context, geom.get()));
-                        }
+                    // Lazy-initialize coverage
+                    if (coverage == nullptr) {
+                        coverage = std::make_unique<Raster<float>>(
+                                raster_cell_intersection(subgrid, geom));
+                    }
 
-                        auto values = op.values->read_box(subgrid.extent().intersection(op.values->grid().extent()));
+                    auto values = op.values->read_box(subgrid.extent().intersection(op.values->grid().extent()));
 
-                        if (op.weighted()) {
-                            auto weights = op.weights->read_box(subgrid.extent().intersection(op.weights->grid().extent()));
+                    std::unique_ptr<AbstractRaster<double>> weights;
+                    if (op.weighted()) {
+                        weights = op.weights->read_box(subgrid.extent().intersection(op.weights->grid().extent()));
 
-                            m_reg.stats(name, op).process(*coverage, *values, *weights);
-                        } else {
-                            m_reg.stats(name, op).process(*coverage, *values);
-                        }
+                        m_reg.stats(name, op).process(*coverage, *values, *weights);
+                    } else {
+                        m_reg.stats(name, op).process(*coverage, *values);
+                    }
 
-                        progress();
+                    if (m_cell_writer != nullptr) {
+                        m_cell_writer->write(name, op, grid, *coverage, *values, weights.get());
                     }
+
+                    progress();
                 }
             }
-
-            m_output.write(name);
-            m_reg.flush_feature(name);
         }
     }
 }
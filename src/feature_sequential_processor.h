@@ -14,6 +14,7 @@
 #ifndef EXACTEXTRACT_FEATURE_SEQUENTIAL_PROCESSOR_H
 #define EXACTEXTRACT_FEATURE_SEQUENTIAL_PROCESSOR_H
 
+#include "flat_geometry.h"
 #include "processor.h"
 
 namespace exactextract {
@@ -22,6 +23,35 @@ namespace exactextract {
         using Processor::Processor;
 
         void process() override;
+
+        /**
+         * Process features in the order in which the centers of their envelopes
+         * fall along a Hilbert curve, rather than the order in which they are
+         * stored, so that consecutive features tend to read nearby raster blocks.
+         * Requires a layer that supports random reads.
+         */
+        void set_hilbert_order(bool val) {
+            m_hilbert_order = val;
+        }
+
+        /**
+         * When processing features out of order, write results in the order in
+         * which features are stored, retaining statistics for features that have
+         * been processed until all features preceding them have been written.
+         */
+        void set_preserve_order(bool val) {
+            m_preserve_order = val;
+        }
+
+    private:
+        void process_feature(const FeatureId & name, const FlatGeometry & geom);
+
+        void process_in_hilbert_order();
+
+        FlatGeometry m_geometry;
+
+        bool m_hilbert_order = false;
+        bool m_preserve_order = false;
     };
 }
 
@@ -0,0 +1,117 @@
+// Copyright (c) 2020 ISciences, LLC.
+// All rights reserved.
+//
+// This software is licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License. You may
+// obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0.
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+
+#include "feature_spill_store.h"
+
+namespace exactextract {
+
+    template<typename T>
+    static void append_value(std::string & buf, const T & val) {
+        buf.append(reinterpret_cast<const char*>(&val), sizeof(T));
+    }
+
+    FeatureSpillStore::FeatureSpillStore(const std::string & dir, size_t num_buckets, size_t max_buffered_bytes) :
+        m_buffers(num_buckets),
+        m_counts(num_buckets, 0),
+        m_on_disk(num_buckets, false),
+        m_buffered_bytes{0},
+        m_max_buffered_bytes{max_buffered_bytes}
+    {
+        std::random_device rd;
+        std::uniform_int_distribution<unsigned long long> dist;
+        char id[17];
+        std::snprintf(id, sizeof(id), "%016llx", dist(rd));
+
+        m_prefix = dir;
+        if (!m_prefix.empty() && m_prefix.back() != '/') {
+            m_prefix.push_back('/');
+        }
+        m_prefix += "exactextract_" + std::string(id) + "_";
+    }
+
+    FeatureSpillStore::~FeatureSpillStore() {
+        for (size_t i = 0; i < m_on_disk.size(); i++) {
+            if (m_on_disk[i]) {
+                std::remove(path(i).c_str());
+            }
+        }
+    }
+
+    std::string FeatureSpillStore::path(size_t bucket) const {
+        return m_prefix + std::to_string(bucket) + ".bin";
+    }
+
+    void FeatureSpillStore::add(size_t bucket, const FeatureId & name, const FlatGeometry & geom) {
+        std::string& buf = m_buffers[bucket];
+        size_t initial_size = buf.size();
+
+        append_value(buf, static_cast<uint8_t>(name.is_int()));
+        if (name.is_int()) {
+            append_value(buf, name.as_int());
+        } else {
+            append_value(buf, static_cast<uint32_t>(name.as_string().size()));
+            buf.append(name.as_string());
+        }
+
+        append_value(buf, static_cast<uint32_t>(geom.num_polygons()));
+        for (size_t p = 0; p < geom.num_polygons(); p++) {
+            append_value(buf, static_cast<uint32_t>(geom.end_ring(p) - geom.first_ring(p)));
+            for (size_t r = geom.first_ring(p); r < geom.end_ring(p); r++) {
+                auto ring = geom.ring(r);
+                append_value(buf, static_cast<uint32_t>(ring.size()));
+                buf.append(reinterpret_cast<const char*>(ring.begin()), ring.size() * sizeof(Coordinate));
+            }
+        }
+
+        m_counts[bucket]++;
+        m_buffered_bytes += buf.size() - initial_size;
+
+        while (m_buffered_bytes > m_max_buffered_bytes) {
+            auto largest = std::max_element(m_buffers.begin(), m_buffers.end(),
+                    [](const auto& a, const auto& b) { return a.size() < b.size(); });
+            flush(static_cast<size_t>(largest - m_buffers.begin()));
+        }
+    }
+
+    void FeatureSpillStore::flush(size_t bucket) {
+        std::string& buf = m_buffers[bucket];
+
+        if (buf.empty()) {
+            return;
+        }
+
+        std::ofstream out(path(bucket), std::ios::binary | std::ios::app);
+        m_on_disk[bucket] = true;
+
+        out.write(buf.data(), static_cast<std::streamsize>(buf.size()));
+        if (!out) {
+            throw std::runtime_error("Failed to write to " + path(bucket));
+        }
+
+        m_buffered_bytes -= buf.size();
+        buf.clear();
+        buf.shrink_to_fit();
+    }
+
+    void FeatureSpillStore::read_bytes(std::istream & in, void* dst, size_t n) {
+        in.read(static_cast<char*>(dst), static_cast<std::streamsize>(n));
+        if (!in) {
+            throw std::runtime_error("Unexpected end of spilled feature data.");
+        }
+    }
+
+}
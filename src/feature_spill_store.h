@@ -0,0 +1,133 @@
+// Copyright (c) 2020 ISciences, LLC.
+// All rights reserved.
+//
+// This software is licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License. You may
+// obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0.
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef EXACTEXTRACT_FEATURE_SPILL_STORE_H
+#define EXACTEXTRACT_FEATURE_SPILL_STORE_H
+
+#include <cstdint>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "feature_id.h"
+#include "flat_geometry.h"
+
+namespace exactextract {
+
+    /**
+     * Stores features (an ID and a FlatGeometry) in a fixed number of buckets
+     * backed by temporary files, so that the features of one bucket can be
+     * read back without holding the features of the other buckets in memory.
+     * Records appended to a bucket are buffered in memory; when the total size
+     * of the buffers exceeds a limit, the largest buffer is appended to its
+     * file. The files are removed when the store is destroyed.
+     */
+    class FeatureSpillStore {
+    public:
+        FeatureSpillStore(const std::string & dir, size_t num_buckets, size_t max_buffered_bytes = 64*1024*1024);
+
+        ~FeatureSpillStore();
+
+        FeatureSpillStore(const FeatureSpillStore&) = delete;
+        FeatureSpillStore& operator=(const FeatureSpillStore&) = delete;
+
+        void add(size_t bucket, const FeatureId & name, const FlatGeometry & geom);
+
+        size_t num_buckets() const {
+            return m_buffers.size();
+        }
+
+        /** Return the number of features that have been added to a bucket. */
+        size_t size(size_t bucket) const {
+            return m_counts[bucket];
+        }
+
+        /**
+         * Invoke `f(const FeatureId & name, const FlatGeometry & geom)` for each
+         * feature in a bucket, in the order in which they were added. The
+         * FlatGeometry passed to `f` is reused for subsequent features.
+         */
+        template<typename F>
+        void read(size_t bucket, F && f);
+
+    private:
+        std::string path(size_t bucket) const;
+
+        void flush(size_t bucket);
+
+        static void read_bytes(std::istream & in, void* dst, size_t n);
+
+        template<typename T>
+        static T read_value(std::istream & in) {
+            T val;
+            read_bytes(in, &val, sizeof(T));
+            return val;
+        }
+
+        std::string m_prefix;
+        std::vector<std::string> m_buffers;
+        std::vector<size_t> m_counts;
+        std::vector<bool> m_on_disk;
+        size_t m_buffered_bytes;
+        size_t m_max_buffered_bytes;
+    };
+
+    template<typename F>
+    void FeatureSpillStore::read(size_t bucket, F && f) {
+        if (m_counts[bucket] == 0) {
+            return;
+        }
+
+        flush(bucket);
+
+        std::ifstream in(path(bucket), std::ios::binary);
+        if (!in) {
+            throw std::runtime_error("Failed to open " + path(bucket));
+        }
+
+        std::string str;
+        FeatureId name;
+        FlatGeometry geom;
+
+        for (size_t i = 0; i < m_counts[bucket]; i++) {
+            if (read_value<uint8_t>(in)) {
+                name = read_value<int64_t>(in);
+            } else {
+                str.resize(read_value<uint32_t>(in));
+                read_bytes(in, &str[0], str.size());
+                name = str;
+            }
+
+            geom.clear();
+            auto num_polygons = read_value<uint32_t>(in);
+            for (uint32_t p = 0; p < num_polygons; p++) {
+                geom.add_polygon();
+                auto num_rings = read_value<uint32_t>(in);
+                for (uint32_t r = 0; r < num_rings; r++) {
+                    geom.add_ring();
+                    auto num_coords = read_value<uint32_t>(in);
+                    for (uint32_t c = 0; c < num_coords; c++) {
+                        auto coord = read_value<Coordinate>(in);
+                        geom.add_coordinate(coord.x, coord.y);
+                    }
+                }
+            }
+
+            f(name, geom);
+        }
+    }
+
+}
+
+#endif
@@ -0,0 +1,287 @@
+// Copyright (c) 2020 ISciences, LLC.
+// All rights reserved.
+//
+// This software is licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License. You may
+// obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0.
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+#include "flat_geometry.h"
+
+namespace exactextract {
+
+    Box ring_box(const CoordinateRange & ring) {
+        if (ring.empty()) {
+            return Box::make_empty();
+        }
+
+        Box box{ring.front().x, ring.front().y, ring.front().x, ring.front().y};
+        for (const auto& c : ring) {
+            box.xmin = std::min(box.xmin, c.x);
+            box.ymin = std::min(box.ymin, c.y);
+            box.xmax = std::max(box.xmax, c.x);
+            box.ymax = std::max(box.ymax, c.y);
+        }
+
+        return box;
+    }
+
+    Box FlatGeometry::box() const {
+        return ring_box(CoordinateRange(m_coords));
+    }
+
+    std::vector<Box> FlatGeometry::component_boxes() const {
+        std::vector<Box> boxes;
+        boxes.reserve(num_polygons());
+
+        for (size_t i = 0; i < num_polygons(); i++) {
+            if (first_ring(i) < end_ring(i)) {
+                auto shell = ring(first_ring(i));
+                if (!shell.empty()) {
+                    boxes.push_back(ring_box(shell));
+                }
+            }
+        }
+
+        return boxes;
+    }
+
+    static bool point_on_segment(const Coordinate & p, const Coordinate & a, const Coordinate & b) {
+        if (p.x < std::min(a.x, b.x) || p.x > std::max(a.x, b.x) ||
+            p.y < std::min(a.y, b.y) || p.y > std::max(a.y, b.y)) {
+            return false;
+        }
+
+        return (b.x - a.x) * (p.y - a.y) == (b.y - a.y) * (p.x - a.x);
+    }
+
+    bool point_in_ring(const Coordinate & p, const CoordinateRange & ring) {
+        bool inside = false;
+
+        for (size_t i = 1; i < ring.size(); i++) {
+            const Coordinate& a = ring[i - 1];
+            const Coordinate& b = ring[i];
+
+            if (point_on_segment(p, a, b)) {
+                return false;
+            }
+
+            // Count crossings of a ray extending to the right of p
+            if ((a.y > p.y) != (b.y > p.y)) {
+                double x = a.x + (p.y - a.y) * (b.x - a.x) / (b.y - a.y);
+                if (p.x < x) {
+                    inside = !inside;
+                }
+            }
+        }
+
+        return inside;
+    }
+
+    namespace {
+
+        class WkbReader {
+        public:
+            WkbReader(const unsigned char* wkb, size_t size) : m_wkb{wkb}, m_size{size}, m_pos{0}, m_swap{false}, m_box{Box::make_empty()}, m_has_box{false} {}
+
+            // Read a geometry, appending it to `geom` unless it is null. The
+            // extent of the coordinates read is available from box().
+            void read_geometry(FlatGeometry* geom) {
+                m_swap = read_byte_order();
+
+                uint32_t type = read_uint32();
+
+                // EWKB flags
+                bool has_z = type & 0x80000000u;
+                bool has_m = type & 0x40000000u;
+                bool has_srid = type & 0x20000000u;
+                type &= 0x0fffffffu;
+
+                // ISO WKB type codes
+                if (type >= 1000) {
+                    uint32_t dims = type / 1000;
+                    has_z = has_z || dims == 1 || dims == 3;
+                    has_m = has_m || dims == 2 || dims == 3;
+                    type %= 1000;
+                }
+
+                if (has_srid) {
+                    read_uint32();
+                }
+
+                size_t dim = 2 + (has_z ? 1 : 0) + (has_m ? 1 : 0);
+
+                switch(type) {
+                    case 3:
+                        read_polygon(geom, dim);
+                        break;
+                    case 6:
+                    case 7: {
+                        uint32_t n = read_uint32();
+                        for (uint32_t i = 0; i < n; i++) {
+                            read_geometry(geom);
+                        }
+                        break;
+                    }
+                    default:
+                        throw std::invalid_argument("Unsupported geometry type.");
+                }
+            }
+
+            const Box & box() const {
+                return m_box;
+            }
+
+        private:
+            void read_polygon(FlatGeometry* geom, size_t dim) {
+                uint32_t num_rings = read_uint32();
+
+                bool added = false;
+                for (uint32_t i = 0; i < num_rings; i++) {
+                    uint32_t num_points = read_uint32();
+
+                    if (num_points == 0) {
+                        continue;
+                    }
+
+                    if (num_points < 4) {
+                        throw std::runtime_error("Polygon ring has fewer than 4 points.");
+                    }
+
+                    check_available(static_cast<size_t>(num_points) * dim * sizeof(double));
+
+                    if (!added) {
+                        if (i > 0) {
+                            // Holes in a polygon with an empty exterior ring
+                            throw std::runtime_error("Polygon has an empty exterior ring.");
+                        }
+                        if (geom) {
+                            geom->add_polygon();
+                        }
+                        added = true;
+                    }
+
+                    if (geom) {
+                        geom->add_ring();
+                    }
+
+                    double x0 = 0, y0 = 0, x = 0, y = 0;
+                    for (uint32_t j = 0; j < num_points; j++) {
+                        x = read_double();
+                        y = read_double();
+                        m_pos += (dim - 2) * sizeof(double);
+
+                        if (j == 0) {
+                            x0 = x;
+                            y0 = y;
+                        }
+
+                        if (geom) {
+                            geom->add_coordinate(x, y);
+                        }
+
+                        if (m_has_box) {
+                            m_box.xmin = std::min(m_box.xmin, x);
+                            m_box.ymin = std::min(m_box.ymin, y);
+                            m_box.xmax = std::max(m_box.xmax, x);
+                            m_box.ymax = std::max(m_box.ymax, y);
+                        } else {
+                            m_box = {x, y, x, y};
+                            m_has_box = true;
+                        }
+                    }
+
+                    if (x != x0 || y != y0) {
+                        throw std::runtime_error("Polygon ring is not closed.");
+                    }
+                }
+            }
+
+            bool read_byte_order() {
+                check_available(1);
+                unsigned char order = m_wkb[m_pos++];
+
+                if (order > 1) {
+                    throw std::runtime_error("Invalid WKB byte order.");
+                }
+
+                // 1 indicates little-endian (NDR) data
+                return (order == 1) != host_is_little_endian();
+            }
+
+            uint32_t read_uint32() {
+                uint32_t val;
+                read(&val, sizeof(val));
+                return val;
+            }
+
+            double read_double() {
+                double val;
+                read(&val, sizeof(val));
+                return val;
+            }
+
+            void read(void* dst, size_t n) {
+                check_available(n);
+
+                auto out = static_cast<unsigned char*>(dst);
+                if (m_swap) {
+                    std::reverse_copy(m_wkb + m_pos, m_wkb + m_pos + n, out);
+                } else {
+                    std::memcpy(out, m_wkb + m_pos, n);
+                }
+
+                m_pos += n;
+            }
+
+            void check_available(size_t n) const {
+                if (n > m_size - m_pos) {
+                    throw std::runtime_error("Unexpected end of WKB.");
+                }
+            }
+
+            static bool host_is_little_endian() {
+                uint16_t x = 1;
+                unsigned char c;
+                std::memcpy(&c, &x, 1);
+                return c == 1;
+            }
+
+            const unsigned char* m_wkb;
+            size_t m_size;
+            size_t m_pos;
+            bool m_swap;
+            Box m_box;
+            bool m_has_box;
+        };
+
+    }
+
+    void read_wkb(const unsigned char* wkb, size_t size, FlatGeometry & geom) {
+        WkbReader reader(wkb, size);
+        reader.read_geometry(&geom);
+    }
+
+    FlatGeometry read_wkb(const unsigned char* wkb, size_t size) {
+        FlatGeometry geom;
+        read_wkb(wkb, size, geom);
+        return geom;
+    }
+
+    Box wkb_envelope(const unsigned char* wkb, size_t size) {
+        WkbReader reader(wkb, size);
+        reader.read_geometry(nullptr);
+        return reader.box();
+    }
+
+}
@@ -0,0 +1,128 @@
+// Copyright (c) 2020 ISciences, LLC.
+// All rights reserved.
+//
+// This software is licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License. You may
+// obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0.
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef EXACTEXTRACT_FLAT_GEOMETRY_H
+#define EXACTEXTRACT_FLAT_GEOMETRY_H
+
+#include <cstddef>
+#include <vector>
+
+#include "box.h"
+#include "coordinate.h"
+
+namespace exactextract {
+
+    /**
+     * A polygonal geometry whose coordinates are stored in a single array,
+     * with offsets marking the first coordinate of each ring and the first
+     * ring of each polygon. The first ring of each polygon is its exterior
+     * ring; any others are holes. This is all that is needed to compute cell
+     * coverage fractions, without constructing a GEOS geometry.
+     */
+    class FlatGeometry {
+    public:
+        /** Begin a new polygon. Rings added after this call belong to it. */
+        void add_polygon() {
+            m_polygon_offsets.push_back(m_ring_offsets.size());
+        }
+
+        /** Begin a new ring in the current polygon. */
+        void add_ring() {
+            m_ring_offsets.push_back(m_coords.size());
+        }
+
+        /** Add a coordinate to the current ring. */
+        void add_coordinate(double x, double y) {
+            m_coords.emplace_back(x, y);
+        }
+
+        void reserve(size_t num_coords) {
+            m_coords.reserve(num_coords);
+        }
+
+        void clear() {
+            m_coords.clear();
+            m_ring_offsets.clear();
+            m_polygon_offsets.clear();
+        }
+
+        bool empty() const {
+            return m_coords.empty();
+        }
+
+        size_t num_polygons() const {
+            return m_polygon_offsets.size();
+        }
+
+        size_t num_rings() const {
+            return m_ring_offsets.size();
+        }
+
+        size_t num_coordinates() const {
+            return m_coords.size();
+        }
+
+        /** Return the index of the exterior ring of polygon `i`. */
+        size_t first_ring(size_t i) const {
+            return m_polygon_offsets[i];
+        }
+
+        /** Return one past the index of the last ring of polygon `i`. */
+        size_t end_ring(size_t i) const {
+            return i + 1 < m_polygon_offsets.size() ? m_polygon_offsets[i + 1] : m_ring_offsets.size();
+        }
+
+        CoordinateRange ring(size_t i) const {
+            size_t end = i + 1 < m_ring_offsets.size() ? m_ring_offsets[i + 1] : m_coords.size();
+            return { m_coords.data() + m_ring_offsets[i], m_coords.data() + end };
+        }
+
+        /** Return the extent of all coordinates, or Box::make_empty() if there are none. */
+        Box box() const;
+
+        /** Return the extent of the exterior ring of each non-empty polygon. */
+        std::vector<Box> component_boxes() const;
+
+    private:
+        std::vector<Coordinate> m_coords;
+        std::vector<size_t> m_ring_offsets;
+        std::vector<size_t> m_polygon_offsets;
+    };
+
+    /** Return the extent of a sequence of coordinates, or Box::make_empty() if it is empty. */
+    Box ring_box(const CoordinateRange & ring);
+
+    /**
+     * Determine whether a point falls strictly within a closed ring. Points on
+     * the boundary of the ring are not considered to be inside it.
+     */
+    bool point_in_ring(const Coordinate & p, const CoordinateRange & ring);
+
+    /**
+     * Read a Polygon, MultiPolygon, or GeometryCollection of Polygons from
+     * WKB, appending it to `geom`. Z and M values (ISO or EWKB) are ignored.
+     * Empty rings are skipped.
+     */
+    void read_wkb(const unsigned char* wkb, size_t size, FlatGeometry & geom);
+
+    FlatGeometry read_wkb(const unsigned char* wkb, size_t size);
+
+    /**
+     * Return the extent of a geometry that read_wkb would accept, without
+     * building it, or Box::make_empty() if it has no coordinates.
+     */
+    Box wkb_envelope(const unsigned char* wkb, size_t size);
+
+}
+
+#endif
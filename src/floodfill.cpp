@@ -11,31 +11,21 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
-#include <geos_c.h>
-
 #include "grid.h"
+#include "flat_geometry.h"
 #include "floodfill.h"
-#include "geos_utils.h"
 
 namespace exactextract {
 
-    FloodFill::FloodFill(GEOSContextHandle_t context, const GEOSGeometry *g, const Grid<bounded_extent> &extent) :
+    FloodFill::FloodFill(const CoordinateRange &ring, const Grid<bounded_extent> &extent) :
             m_extent{extent},
-            m_geos_context{context},
-            m_g{nullptr},
-            m_pg{nullptr} {
-        geom_ptr_r ring_copy = geos_ptr(context, GEOSGeom_clone_r(context, g));
-        m_g = geos_ptr(context, GEOSGeom_createPolygon_r(context, ring_copy.release(), nullptr, 0));
-        m_pg = GEOSPrepare_ptr(context, m_g.get());
-    }
+            m_ring{ring} {}
 
     bool FloodFill::cell_is_inside(size_t i, size_t j) const {
         double x = m_extent.x_for_col(j);
         double y = m_extent.y_for_row(i);
 
-        auto point = GEOSGeom_createPoint_ptr(m_geos_context, x, y);
-
-        return GEOSPreparedContains_r(m_geos_context, m_pg.get(), point.get());
+        return point_in_ring({x, y}, m_ring);
     }
 
 }
@@ -15,11 +15,10 @@
 #define EXACTEXTRACT_FLOODFILL_H
 
 #include <queue>
+#include <stdexcept>
 
-#include <geos_c.h>
-
+#include "coordinate.h"
 #include "grid.h"
-#include "geos_utils.h"
 #include "matrix.h"
 
 namespace exactextract {
@@ -44,7 +43,11 @@ namespace exactextract {
     class FloodFill {
 
     public:
-        FloodFill(GEOSContextHandle_t context, const GEOSGeometry *g, const Grid<bounded_extent> &extent);
+        /**
+         * Construct a FloodFill for a closed ring. The coordinates referenced by
+         * `ring` must remain valid for the lifetime of the FloodFill.
+         */
+        FloodFill(const CoordinateRange &ring, const Grid<bounded_extent> &extent);
 
         template<typename T>
         void flood(Matrix<T> &arr) const;
@@ -53,9 +56,7 @@ namespace exactextract {
 
     private:
         Grid<bounded_extent> m_extent;
-        GEOSContextHandle_t m_geos_context;
-        geom_ptr_r m_g;
-        prep_geom_ptr_r m_pg;
+        CoordinateRange m_ring;
     };
 
     template<typename T>
@@ -0,0 +1,138 @@
+// Copyright (c) 2021 ISciences, LLC.
+// All rights reserved.
+//
+// This software is licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License. You may
+// obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0.
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "gdal_coverage_raster_writer.h"
+
+#include "gdal.h"
+#include "cpl_string.h"
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#if GDAL_VERSION_NUM >= GDAL_COMPUTE_VERSION(3, 5, 0)
+#define EXACTEXTRACT_HAVE_INT64_RASTER 1
+#else
+#define EXACTEXTRACT_HAVE_INT64_RASTER 0
+#endif
+
+namespace exactextract {
+
+#if EXACTEXTRACT_HAVE_INT64_RASTER
+    // Written to cells not covered by any feature in the ARGMAX output
+    static constexpr int64_t ARGMAX_NODATA = std::numeric_limits<int64_t>::min();
+#endif
+
+    GDALCoverageRasterWriter::GDALCoverageRasterWriter(const std::string & filename,
+                                                       Method method,
+                                                       const Grid<bounded_extent> & grid,
+                                                       const std::string & projection) :
+        CoverageRasterWriter(method),
+        m_grid{grid}
+    {
+        auto driver = GDALGetDriverByName("GTiff");
+        if (driver == nullptr) {
+            throw std::runtime_error("Could not load output driver: GTiff");
+        }
+
+        char** creation_options = nullptr;
+        creation_options = CSLSetNameValue(creation_options, "TILED", "YES");
+        creation_options = CSLSetNameValue(creation_options, "COMPRESS", "DEFLATE");
+        creation_options = CSLSetNameValue(creation_options, "BIGTIFF", "IF_SAFER");
+
+        // Fractions need only single precision. Feature IDs are written as
+        // integers where GDAL supports 64-bit integer rasters.
+#if EXACTEXTRACT_HAVE_INT64_RASTER
+        GDALDataType id_type = GDT_Int64;
+#else
+        GDALDataType id_type = GDT_Float64;
+#endif
+        GDALDataType type = method == Method::ARGMAX ? id_type : GDT_Float32;
+
+        m_dataset = GDALCreate(driver, filename.c_str(),
+                               static_cast<int>(grid.cols()), static_cast<int>(grid.rows()), 1,
+                               type, creation_options);
+        CSLDestroy(creation_options);
+
+        if (m_dataset == nullptr) {
+            throw std::runtime_error("Could not create output: " + filename);
+        }
+
+        double transform[6] = {grid.xmin(), grid.dx(), 0, grid.ymax(), 0, -grid.dy()};
+        GDALSetGeoTransform(m_dataset, transform);
+        if (!projection.empty()) {
+            GDALSetProjection(m_dataset, projection.c_str());
+        }
+
+        m_band = GDALGetRasterBand(m_dataset, 1);
+
+        // Blocks that are never written are filled with the nodata value.
+        if (method == Method::ARGMAX) {
+#if EXACTEXTRACT_HAVE_INT64_RASTER
+            GDALSetRasterNoDataValueAsInt64(m_band, ARGMAX_NODATA);
+#else
+            GDALSetRasterNoDataValue(m_band, std::numeric_limits<double>::quiet_NaN());
+#endif
+        }
+    }
+
+    GDALCoverageRasterWriter::~GDALCoverageRasterWriter() {
+        if (m_dataset != nullptr) {
+            GDALClose(m_dataset);
+        }
+    }
+
+    void GDALCoverageRasterWriter::write_window(Raster<double> & window) {
+        if (window.rows() == 0 || window.cols() == 0) {
+            return;
+        }
+
+        auto x0 = static_cast<int>(m_grid.col_offset(window.grid()));
+        auto y0 = static_cast<int>(m_grid.row_offset(window.grid()));
+        auto nx = static_cast<int>(window.cols());
+        auto ny = static_cast<int>(window.rows());
+
+#if EXACTEXTRACT_HAVE_INT64_RASTER
+        if (method() == Method::ARGMAX) {
+            // Convert the IDs here, since GDAL would not convert NaN to the
+            // nodata value.
+            std::vector<int64_t> ids(window.rows() * window.cols());
+            for (size_t i = 0; i < window.rows(); i++) {
+                for (size_t j = 0; j < window.cols(); j++) {
+                    double id = window(i, j);
+                    ids[i * window.cols() + j] = std::isnan(id) ? ARGMAX_NODATA : static_cast<int64_t>(id);
+                }
+            }
+
+            if (GDALRasterIO(m_band, GF_Write, x0, y0, nx, ny, ids.data(), nx, ny, GDT_Int64, 0, 0) != CE_None) {
+                throw std::runtime_error("Error writing coverage raster.");
+            }
+            return;
+        }
+#endif
+
+        if (GDALRasterIO(m_band, GF_Write, x0, y0, nx, ny, window.data().data(), nx, ny, GDT_Float64, 0, 0) != CE_None) {
+            throw std::runtime_error("Error writing coverage raster.");
+        }
+    }
+
+    void GDALCoverageRasterWriter::finish() {
+        if (m_dataset != nullptr) {
+            GDALClose(m_dataset);
+            m_dataset = nullptr;
+        }
+    }
+
+}
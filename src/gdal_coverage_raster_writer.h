@@ -0,0 +1,52 @@
+// Copyright (c) 2021 ISciences, LLC.
+// All rights reserved.
+//
+// This software is licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License. You may
+// obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0.
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef EXACTEXTRACT_GDAL_COVERAGE_RASTER_WRITER_H
+#define EXACTEXTRACT_GDAL_COVERAGE_RASTER_WRITER_H
+
+#include <string>
+
+#include "coverage_raster_writer.h"
+
+namespace exactextract {
+
+    /**
+     * Writes combined coverage fractions to a tiled GeoTIFF aligned with
+     * `grid`, one window at a time.
+     */
+    class GDALCoverageRasterWriter : public CoverageRasterWriter {
+    public:
+        GDALCoverageRasterWriter(const std::string & filename,
+                                 Method method,
+                                 const Grid<bounded_extent> & grid,
+                                 const std::string & projection);
+
+        ~GDALCoverageRasterWriter() override;
+
+        void finish() override;
+
+    protected:
+        void write_window(Raster<double> & window) override;
+
+    private:
+        using GDALDatasetH = void*;
+        using GDALRasterBandH = void*;
+
+        GDALDatasetH m_dataset;
+        GDALRasterBandH m_band;
+        Grid<bounded_extent> m_grid;
+    };
+
+}
+
+#endif //EXACTEXTRACT_GDAL_COVERAGE_RASTER_WRITER_H
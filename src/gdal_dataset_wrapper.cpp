@@ -14,12 +14,169 @@
 #include "gdal_dataset_wrapper.h"
 
 #include <algorithm>
+#include <cstdint>
+#include <cstdio>
 #include <memory>
+#include <unordered_map>
+
+#include <cpl_string.h>
+
+#if GDAL_VERSION_NUM >= GDAL_COMPUTE_VERSION(3, 6, 0)
+#define EXACTEXTRACT_HAVE_ARROW_STREAM 1
+#include <ogr_recordbatch.h>
+#else
+#define EXACTEXTRACT_HAVE_ARROW_STREAM 0
+#endif
 
 namespace exactextract {
 
+#if EXACTEXTRACT_HAVE_ARROW_STREAM
+    /**
+     * Reads features from a layer in batches using the Arrow C stream
+     * interface. Geometries are accessed as WKB within the batch, and
+     * fields as columns, without creating an OGRFeature for each feature.
+     */
+    struct GDALDatasetWrapper::ArrowReader {
+        ArrowArrayStream stream;
+        ArrowSchema schema;
+        ArrowArray batch;
+        int64_t row;
+        int64_t fid_col;
+        int64_t geom_col;
+        int64_t id_col;
+        std::unordered_map<std::string, int64_t> field_cols;
+
+        ArrowReader() : row{-1}, fid_col{-1}, geom_col{-1}, id_col{-1} {
+            stream.release = nullptr;
+            schema.release = nullptr;
+            batch.release = nullptr;
+        }
+
+        ~ArrowReader() {
+            if (batch.release != nullptr) {
+                batch.release(&batch);
+            }
+            if (schema.release != nullptr) {
+                schema.release(&schema);
+            }
+            if (stream.release != nullptr) {
+                stream.release(&stream);
+            }
+        }
+
+        ArrowReader(const ArrowReader&) = delete;
+        ArrowReader& operator=(const ArrowReader&) = delete;
+
+        bool next() {
+            while (true) {
+                if (batch.release != nullptr && row + 1 < batch.length) {
+                    row++;
+                    return true;
+                }
+
+                if (batch.release != nullptr) {
+                    batch.release(&batch);
+                    batch.release = nullptr;
+                }
+
+                if (stream.get_next(&stream, &batch) != 0) {
+                    const char* err = stream.get_last_error(&stream);
+                    throw std::runtime_error(std::string("Error reading features: ") + (err ? err : ""));
+                }
+
+                if (batch.release == nullptr) {
+                    // End of stream
+                    return false;
+                }
+
+                row = -1;
+            }
+        }
+
+        const char* format(int64_t col) const {
+            return schema.children[col]->format;
+        }
+
+        const ArrowArray* column(int64_t col) const {
+            return batch.children[col];
+        }
+
+        bool is_valid(int64_t col) const {
+            const ArrowArray* arr = column(col);
+            const auto* validity = static_cast<const uint8_t*>(arr->buffers[0]);
+
+            if (validity == nullptr) {
+                return true;
+            }
+
+            int64_t i = arr->offset + row;
+            return validity[i / 8] & (1 << (i % 8));
+        }
+
+        template<typename T>
+        T value(int64_t col) const {
+            const ArrowArray* arr = column(col);
+            return static_cast<const T*>(arr->buffers[1])[arr->offset + row];
+        }
+
+        std::pair<const unsigned char*, size_t> binary(int64_t col) const {
+            const ArrowArray* arr = column(col);
+            int64_t i = arr->offset + row;
+            const auto* data = static_cast<const unsigned char*>(arr->buffers[2]);
+
+            // Binary and string columns have 32-bit offsets; "large" variants have 64-bit offsets.
+            if (format(col)[0] == 'z' || format(col)[0] == 'u') {
+                const auto* offsets = static_cast<const int32_t*>(arr->buffers[1]);
+                return { data + offsets[i], static_cast<size_t>(offsets[i + 1] - offsets[i]) };
+            } else {
+                const auto* offsets = static_cast<const int64_t*>(arr->buffers[1]);
+                return { data + offsets[i], static_cast<size_t>(offsets[i + 1] - offsets[i]) };
+            }
+        }
+
+        std::string as_string(int64_t col) const {
+            if (!is_valid(col)) {
+                return "";
+            }
+
+            switch(format(col)[0]) {
+                case 'c': return std::to_string(value<int8_t>(col));
+                case 'C': return std::to_string(value<uint8_t>(col));
+                case 's': return std::to_string(value<int16_t>(col));
+                case 'S': return std::to_string(value<uint16_t>(col));
+                case 'i': return std::to_string(value<int32_t>(col));
+                case 'I': return std::to_string(value<uint32_t>(col));
+                case 'l': return std::to_string(value<int64_t>(col));
+                case 'L': return std::to_string(value<uint64_t>(col));
+                case 'f': return format_real(static_cast<double>(value<float>(col)));
+                case 'g': return format_real(value<double>(col));
+                case 'u':
+                case 'U': {
+                    auto str = binary(col);
+                    return std::string(reinterpret_cast<const char*>(str.first), str.second);
+                }
+                default:
+                    throw std::runtime_error("Unsupported field type.");
+            }
+        }
+
+        static bool supports_format(const char* fmt) {
+            return fmt[0] != '\0' && fmt[1] == '\0' && std::string("cCsSiIlLfguU").find(fmt[0]) != std::string::npos;
+        }
+
+        static std::string format_real(double d) {
+            char buf[32];
+            std::snprintf(buf, sizeof(buf), "%.15g", d);
+            return buf;
+        }
+    };
+#else
+    struct GDALDatasetWrapper::ArrowReader {};
+#endif
+
     GDALDatasetWrapper::GDALDatasetWrapper(const std::string & filename, const std::string & layer, std::string id_field) :
-    m_id_field{std::move(id_field)}
+    m_id_field{std::move(id_field)},
+    m_arrow_checked{false}
     {
         m_dataset = GDALOpenEx(filename.c_str(), GDAL_OF_VECTOR, nullptr, nullptr, nullptr);
         if (m_dataset == nullptr) {
@@ -48,17 +205,205 @@ namespace exactextract {
         if (index == -1) {
             throw std::runtime_error("ID field '" + m_id_field + "' not found in " + filename + ".");
         }
+
+        auto id_type = OGR_Fld_GetType(OGR_FD_GetFieldDefn(defn, index));
+        m_id_index = index;
+        m_id_is_int = id_type == OFTInteger || id_type == OFTInteger64;
+    }
+
+    GDALDatasetWrapper::GDALDatasetWrapper(GDALDatasetWrapper && src) noexcept :
+        m_dataset{src.m_dataset},
+        m_feature{src.m_feature},
+        m_layer{src.m_layer},
+        m_id_field{std::move(src.m_id_field)},
+        m_id_index{src.m_id_index},
+        m_id_is_int{src.m_id_is_int},
+        m_arrow{std::move(src.m_arrow)},
+        m_arrow_checked{src.m_arrow_checked}
+    {
+        src.m_dataset = nullptr;
+        src.m_feature = nullptr;
+        src.m_layer = nullptr;
+    }
+
+    void GDALDatasetWrapper::open_arrow_stream() {
+        m_arrow_checked = true;
+
+#if EXACTEXTRACT_HAVE_ARROW_STREAM
+        // The generic implementation of GetArrowStream is built on GetNextFeature,
+        // so there is no benefit to using it unless the driver provides its own.
+        if (!OGR_L_TestCapability(m_layer, OLCFastGetArrowStream)) {
+            return;
+        }
+
+        // Only read the fields that we need.
+        auto defn = OGR_L_GetLayerDefn(m_layer);
+        char** ignored = nullptr;
+        for (int i = 0; i < OGR_FD_GetFieldCount(defn); i++) {
+            const char* name = OGR_Fld_GetNameRef(OGR_FD_GetFieldDefn(defn, i));
+            if (m_id_field != name) {
+                ignored = CSLAddString(ignored, name);
+            }
+        }
+        OGR_L_SetIgnoredFields(m_layer, const_cast<const char**>(ignored));
+        CSLDestroy(ignored);
+
+        char** options = nullptr;
+        options = CSLSetNameValue(options, "INCLUDE_FID", "YES");
+        options = CSLSetNameValue(options, "GEOMETRY_ENCODING", "WKB");
+
+        auto reader = std::make_unique<ArrowReader>();
+        bool ok = OGR_L_GetArrowStream(m_layer, &reader->stream, options);
+        CSLDestroy(options);
+
+        if (!ok || reader->stream.get_schema(&reader->stream, &reader->schema) != 0) {
+            return;
+        }
+
+        std::string fid_name = OGR_L_GetFIDColumn(m_layer);
+        if (fid_name.empty()) {
+            fid_name = "OGC_FID";
+        }
+
+        std::string geom_name = OGR_L_GetGeometryColumn(m_layer);
+        if (geom_name.empty()) {
+            geom_name = "wkb_geometry";
+        }
+
+        for (int64_t i = 0; i < reader->schema.n_children; i++) {
+            const ArrowSchema* child = reader->schema.children[i];
+            std::string name = child->name;
+            std::string fmt = child->format;
+
+            if (name == fid_name && fmt == "l") {
+                reader->fid_col = i;
+            } else if (name == geom_name && (fmt == "z" || fmt == "Z")) {
+                reader->geom_col = i;
+            } else if (ArrowReader::supports_format(child->format)) {
+                reader->field_cols[name] = i;
+            }
+        }
+
+        // Fall back to reading features one at a time if the stream does not
+        // look the way we expect.
+        if (reader->fid_col == -1 || reader->geom_col == -1 ||
+            reader->field_cols.find(m_id_field) == reader->field_cols.end()) {
+            return;
+        }
+
+        reader->id_col = reader->field_cols[m_id_field];
+
+        m_arrow = std::move(reader);
+#endif
     }
 
     bool GDALDatasetWrapper::next() {
         if (m_feature != nullptr) {
             OGR_F_Destroy(m_feature);
+            m_feature = nullptr;
+        }
+
+        if (!m_arrow_checked) {
+            open_arrow_stream();
         }
+
+#if EXACTEXTRACT_HAVE_ARROW_STREAM
+        if (m_arrow) {
+            return m_arrow->next();
+        }
+#endif
+
         m_feature = OGR_L_GetNextFeature(m_layer);
         return m_feature != nullptr;
     }
 
+    bool GDALDatasetWrapper::seek(GIntBig fid) {
+        if (m_feature != nullptr) {
+            OGR_F_Destroy(m_feature);
+        }
+        m_feature = OGR_L_GetFeature(m_layer, fid);
+        return m_feature != nullptr;
+    }
+
+    void GDALDatasetWrapper::reset() {
+        if (m_feature != nullptr) {
+            OGR_F_Destroy(m_feature);
+            m_feature = nullptr;
+        }
+        m_arrow.reset();
+        m_arrow_checked = false;
+        OGR_L_ResetReading(m_layer);
+    }
+
+    bool GDALDatasetWrapper::supports_random_read() const {
+        return OGR_L_TestCapability(m_layer, OLCRandomRead);
+    }
+
+    void GDALDatasetWrapper::set_spatial_filter(const Box & box) {
+        OGR_L_SetSpatialFilterRect(m_layer, box.xmin, box.ymin, box.xmax, box.ymax);
+        reset();
+    }
+
+    GIntBig GDALDatasetWrapper::feature_count() const {
+        return OGR_L_GetFeatureCount(m_layer, FALSE);
+    }
+
+    Box GDALDatasetWrapper::extent() const {
+        OGREnvelope env;
+        if (OGR_L_GetExtent(m_layer, &env, TRUE) != OGRERR_NONE) {
+            return Box::make_empty();
+        }
+
+        return {env.MinX, env.MinY, env.MaxX, env.MaxY};
+    }
+
+    GIntBig GDALDatasetWrapper::feature_fid() const {
+#if EXACTEXTRACT_HAVE_ARROW_STREAM
+        if (m_feature == nullptr && m_arrow) {
+            return m_arrow->value<int64_t>(m_arrow->fid_col);
+        }
+#endif
+        return OGR_F_GetFID(m_feature);
+    }
+
+    Box GDALDatasetWrapper::feature_envelope() const {
+#if EXACTEXTRACT_HAVE_ARROW_STREAM
+        if (m_feature == nullptr && m_arrow) {
+            if (!m_arrow->is_valid(m_arrow->geom_col)) {
+                return Box::make_empty();
+            }
+
+            // Scan the coordinates in the batch instead of building a geometry
+            auto wkb = m_arrow->binary(m_arrow->geom_col);
+            return wkb_envelope(wkb.first, wkb.second);
+        }
+#endif
+
+        OGRGeometryH geom = OGR_F_GetGeometryRef(m_feature);
+
+        if (geom == nullptr) {
+            return Box::make_empty();
+        }
+
+        OGREnvelope env;
+        OGR_G_GetEnvelope(geom, &env);
+
+        return {env.MinX, env.MinY, env.MaxX, env.MaxY};
+    }
+
     GEOSGeometry* GDALDatasetWrapper::feature_geometry(const GEOSContextHandle_t &geos_context) const {
+#if EXACTEXTRACT_HAVE_ARROW_STREAM
+        if (m_feature == nullptr && m_arrow) {
+            if (!m_arrow->is_valid(m_arrow->geom_col)) {
+                return nullptr;
+            }
+
+            // Parse WKB directly from the batch, without copying it
+            auto wkb = m_arrow->binary(m_arrow->geom_col);
+            return GEOSGeomFromWKB_buf_r(geos_context, wkb.first, wkb.second);
+        }
+#endif
+
         OGRGeometryH geom = OGR_F_GetGeometryRef(m_feature);
 
         auto sz = static_cast<size_t>(OGR_G_WkbSize(geom));
@@ -68,12 +413,149 @@ namespace exactextract {
         return GEOSGeomFromWKB_buf_r(geos_context, buff.get(), sz);
     }
 
+    void GDALDatasetWrapper::feature_geometry(FlatGeometry & geom) const {
+        geom.clear();
+
+#if EXACTEXTRACT_HAVE_ARROW_STREAM
+        if (m_feature == nullptr && m_arrow) {
+            if (m_arrow->is_valid(m_arrow->geom_col)) {
+                auto wkb = m_arrow->binary(m_arrow->geom_col);
+                read_wkb(wkb.first, wkb.second, geom);
+            }
+            return;
+        }
+#endif
+
+        OGRGeometryH ogr_geom = OGR_F_GetGeometryRef(m_feature);
+        if (ogr_geom == nullptr) {
+            return;
+        }
+
+        auto sz = static_cast<size_t>(OGR_G_WkbSize(ogr_geom));
+        auto buff = std::make_unique<unsigned char[]>(sz);
+        OGR_G_ExportToWkb(ogr_geom, wkbNDR, buff.get());
+
+        read_wkb(buff.get(), sz, geom);
+    }
+
     std::string GDALDatasetWrapper::feature_field(const std::string &field_name) const {
+#if EXACTEXTRACT_HAVE_ARROW_STREAM
+        if (m_feature == nullptr && m_arrow) {
+            auto it = m_arrow->field_cols.find(field_name);
+            if (it == m_arrow->field_cols.end()) {
+                throw std::runtime_error("Field " + field_name + " was not read.");
+            }
+            return m_arrow->as_string(it->second);
+        }
+#endif
+
         int index = OGR_F_GetFieldIndex(m_feature, field_name.c_str());
         // TODO check handling of invalid field name
         return OGR_F_GetFieldAsString(m_feature, index);
     }
 
+    static FeatureId field_id(OGRFeatureH feature, int index, bool is_int) {
+        if (is_int && OGR_F_IsFieldSetAndNotNull(feature, index)) {
+            return static_cast<int64_t>(OGR_F_GetFieldAsInteger64(feature, index));
+        }
+
+        return std::string(OGR_F_GetFieldAsString(feature, index));
+    }
+
+    FeatureId GDALDatasetWrapper::feature_id() const {
+#if EXACTEXTRACT_HAVE_ARROW_STREAM
+        if (m_feature == nullptr && m_arrow) {
+            int64_t col = m_arrow->id_col;
+            if (m_arrow->is_valid(col)) {
+                switch(m_arrow->format(col)[0]) {
+                    case 'c': return static_cast<int64_t>(m_arrow->value<int8_t>(col));
+                    case 'C': return static_cast<int64_t>(m_arrow->value<uint8_t>(col));
+                    case 's': return static_cast<int64_t>(m_arrow->value<int16_t>(col));
+                    case 'S': return static_cast<int64_t>(m_arrow->value<uint16_t>(col));
+                    case 'i': return static_cast<int64_t>(m_arrow->value<int32_t>(col));
+                    case 'I': return static_cast<int64_t>(m_arrow->value<uint32_t>(col));
+                    case 'l': return m_arrow->value<int64_t>(col);
+                    default: break;
+                }
+            }
+            return m_arrow->as_string(col);
+        }
+#endif
+
+        return field_id(m_feature, m_id_index, m_id_is_int);
+    }
+
+    std::unordered_map<FeatureId, FeatureId> GDALDatasetWrapper::read_parent_ids(const std::string & parent_field) {
+        auto defn = OGR_L_GetLayerDefn(m_layer);
+        int parent_index = OGR_FD_GetFieldIndex(defn, parent_field.c_str());
+        if (parent_index == -1) {
+            throw std::runtime_error("Cannot find field " + parent_field);
+        }
+
+        auto parent_type = OGR_Fld_GetType(OGR_FD_GetFieldDefn(defn, parent_index));
+        bool parent_is_int = parent_type == OFTInteger || parent_type == OFTInteger64;
+
+        // Read only the ID and parent fields, remembering which fields were
+        // ignored before so that they can be restored afterwards.
+        char** ignored = nullptr;
+        char** previously_ignored = nullptr;
+        for (int i = 0; i < OGR_FD_GetFieldCount(defn); i++) {
+            auto field_defn = OGR_FD_GetFieldDefn(defn, i);
+            const char* name = OGR_Fld_GetNameRef(field_defn);
+            if (OGR_Fld_IsIgnored(field_defn)) {
+                previously_ignored = CSLAddString(previously_ignored, name);
+            }
+            if (i != parent_index && i != m_id_index) {
+                ignored = CSLAddString(ignored, name);
+            }
+        }
+        if (OGR_FD_IsGeometryIgnored(defn)) {
+            previously_ignored = CSLAddString(previously_ignored, "OGR_GEOMETRY");
+        }
+        if (OGR_FD_IsStyleIgnored(defn)) {
+            previously_ignored = CSLAddString(previously_ignored, "OGR_STYLE");
+        }
+        ignored = CSLAddString(ignored, "OGR_GEOMETRY");
+        ignored = CSLAddString(ignored, "OGR_STYLE");
+
+        // Read features one at a time, since an Arrow stream would only
+        // include the ID field.
+        reset();
+        m_arrow_checked = true;
+        OGR_L_SetIgnoredFields(m_layer, const_cast<const char**>(ignored));
+        CSLDestroy(ignored);
+
+        std::unordered_map<FeatureId, FeatureId> parents;
+        try {
+            while (next()) {
+                // Features without a parent are not included in any roll-up.
+                if (!OGR_F_IsFieldSetAndNotNull(m_feature, parent_index)) {
+                    continue;
+                }
+
+                FeatureId id = feature_id();
+                FeatureId parent = field_id(m_feature, parent_index, parent_is_int);
+
+                auto it = parents.emplace(id, parent).first;
+                if (it->second != parent) {
+                    throw std::runtime_error("Feature " + id.to_string() + " has more than one value of " + parent_field);
+                }
+            }
+        } catch (...) {
+            OGR_L_SetIgnoredFields(m_layer, const_cast<const char**>(previously_ignored));
+            CSLDestroy(previously_ignored);
+            reset();
+            throw;
+        }
+
+        OGR_L_SetIgnoredFields(m_layer, const_cast<const char**>(previously_ignored));
+        CSLDestroy(previously_ignored);
+
+        reset();
+
+        return parents;
+    }
+
     void GDALDatasetWrapper::copy_field(const std::string & name, OGRLayerH copy_to) const {
         auto src_layer_defn = OGR_L_GetLayerDefn(m_layer);
         auto src_index = OGR_FD_GetFieldIndex(src_layer_defn, name.c_str());
@@ -88,7 +570,12 @@ namespace exactextract {
     }
 
     GDALDatasetWrapper::~GDALDatasetWrapper(){
-        GDALClose(m_dataset);
+        // Release any Arrow stream before closing the dataset that it reads from
+        m_arrow.reset();
+
+        if (m_dataset != nullptr) {
+            GDALClose(m_dataset);
+        }
 
         if (m_feature != nullptr) {
             OGR_F_Destroy(m_feature);
@@ -16,7 +16,13 @@
 
 #include <gdal.h>
 #include <geos_c.h>
+#include <memory>
 #include <string>
+#include <unordered_map>
+
+#include "box.h"
+#include "feature_id.h"
+#include "flat_geometry.h"
 
 namespace exactextract {
 
@@ -24,23 +30,97 @@ namespace exactextract {
     public:
         GDALDatasetWrapper(const std::string &filename, const std::string & layer, std::string id_field);
 
+        GDALDatasetWrapper(GDALDatasetWrapper && src) noexcept;
+        GDALDatasetWrapper(const GDALDatasetWrapper &) = delete;
+
+        /**
+         * Advance to the next feature. When the driver provides a native
+         * implementation of the Arrow stream interface (GDAL 3.6+), features are
+         * read in batches with geometries as WKB and fields as columns;
+         * otherwise they are read one at a time.
+         */
         bool next();
 
+        /** Make the feature with the given FID current, returning false if it cannot be read. */
+        bool seek(GIntBig fid);
+
+        /** Restart reading from the first feature in the layer. */
+        void reset();
+
+        bool supports_random_read() const;
+
+        /**
+         * Restrict the features returned by next() to those whose geometries
+         * intersect the given box. Drivers with a spatial index can use it to
+         * avoid reading features outside of the box.
+         */
+        void set_spatial_filter(const Box & box);
+
+        /**
+         * Return the number of features in the layer, or -1 if the driver
+         * cannot report it without reading every feature.
+         */
+        GIntBig feature_count() const;
+
+        /**
+         * Return the extent of the features in the layer, or Box::make_empty()
+         * if it cannot be determined.
+         */
+        Box extent() const;
+
+        GIntBig feature_fid() const;
+
+        /**
+         * Return the envelope of the current feature's geometry, without
+         * converting it to GEOS. The envelope of a null geometry is Box::make_empty().
+         */
+        Box feature_envelope() const;
+
         GEOSGeometry* feature_geometry(const GEOSContextHandle_t &geos_context) const;
 
+        /**
+         * Read the polygons of the current feature's geometry into `geom`,
+         * replacing its contents, without constructing a GEOS geometry. A null
+         * geometry leaves `geom` empty.
+         */
+        void feature_geometry(FlatGeometry & geom) const;
+
         std::string feature_field(const std::string &field_name) const;
 
+        /**
+         * Return the value of the ID field of the current feature. Values of
+         * integer fields are returned as integers, without formatting them as
+         * strings; values of other fields, and null values, as strings.
+         */
+        FeatureId feature_id() const;
+
         const std::string& id_field() const { return m_id_field; }
 
+        /**
+         * Read the value of `parent_field` for every feature, returning a map
+         * from the ID of each feature to the value. Features whose value is
+         * null are omitted. An exception is thrown if features with the same
+         * ID have different values.
+         */
+        std::unordered_map<FeatureId, FeatureId> read_parent_ids(const std::string & parent_field);
+
         void copy_field(const std::string & field_name, OGRLayerH to) const;
 
         ~GDALDatasetWrapper();
 
     private:
+        struct ArrowReader;
+
+        void open_arrow_stream();
+
         GDALDatasetH m_dataset;
         OGRFeatureH m_feature;
         OGRLayerH m_layer;
         std::string m_id_field;
+        int m_id_index;
+        bool m_id_is_int;
+        std::unique_ptr<ArrowReader> m_arrow;
+        bool m_arrow_checked;
     };
 
 }
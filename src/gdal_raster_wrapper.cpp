@@ -15,11 +15,21 @@
 
 #include "gdal_raster_wrapper.h"
 
+#include <algorithm>
 #include <stdexcept>
+#include <thread>
 
 namespace exactextract {
 
-    GDALRasterWrapper::GDALRasterWrapper(const std::string &filename, int bandnum) : m_grid{Grid<bounded_extent>::make_empty()} {
+    static CPLErr read_window(GDALRasterBandH band, int x0, int y0, int nx, int ny, double* buf) {
+        return GDALRasterIO(band, GF_Read, x0, y0, nx, ny, buf, nx, ny, GDT_Float64, 0, 0);
+    }
+
+    GDALRasterWrapper::GDALRasterWrapper(const std::string &filename, int bandnum) :
+        m_grid{Grid<bounded_extent>::make_empty()},
+        m_filename{filename},
+        m_bandnum{bandnum},
+        m_read_threads{1} {
         auto rast = GDALOpen(filename.c_str(), GA_ReadOnly);
         if (!rast) {
             throw std::runtime_error("Failed to open " + filename);
@@ -42,6 +52,22 @@ namespace exactextract {
         // So we include a destructor and move constructor to manage the resource.
         if (m_rast != nullptr)
             GDALClose(m_rast);
+
+        for (auto& worker : m_worker_rasters) {
+            GDALClose(worker);
+        }
+    }
+
+    std::string GDALRasterWrapper::projection() const {
+        const char* wkt = GDALGetProjectionRef(m_rast);
+        return wkt == nullptr ? "" : wkt;
+    }
+
+    std::pair<size_t, size_t> GDALRasterWrapper::block_size() const {
+        int block_cols, block_rows;
+        GDALGetBlockSize(m_band, &block_cols, &block_rows);
+
+        return {static_cast<size_t>(block_rows), static_cast<size_t>(block_cols)};
     }
 
     std::unique_ptr<AbstractRaster<double>> GDALRasterWrapper::read_box(const Box &box) {
@@ -52,26 +78,91 @@ namespace exactextract {
             vals->set_nodata(m_nodata_value);
         }
 
-        auto error = GDALRasterIO(m_band,
-                                  GF_Read,
-                                  (int) cropped_grid.col_offset(m_grid),
-                                  (int) cropped_grid.row_offset(m_grid),
-                                  (int) cropped_grid.cols(),
-                                  (int) cropped_grid.rows(),
-                                  vals->data().data(),
-                                  (int) cropped_grid.cols(),
-                                  (int) cropped_grid.rows(),
-                                  GDT_Float64,
-                                  0,
-                                  0);
-
-        if (error) {
+        auto x0 = (int) cropped_grid.col_offset(m_grid);
+        auto y0 = (int) cropped_grid.row_offset(m_grid);
+        auto nx = (int) cropped_grid.cols();
+        auto ny = (int) cropped_grid.rows();
+
+        if (m_read_threads > 1) {
+            read_parallel(x0, y0, nx, ny, vals->data().data());
+        } else if (read_window(m_band, x0, y0, nx, ny, vals->data().data())) {
             throw std::runtime_error("Error reading from raster.");
         }
 
         return vals;
     }
 
+    void GDALRasterWrapper::read_parallel(int x0, int y0, int nx, int ny, double* buf) {
+        int block_cols, block_rows;
+        GDALGetBlockSize(m_band, &block_cols, &block_rows);
+
+        int first_block = y0 / block_rows;
+        int last_block = (y0 + ny - 1) / block_rows;
+        int nblocks = last_block - first_block + 1;
+
+        size_t nstrips = std::min(m_read_threads, static_cast<size_t>(std::max(nblocks, 0)));
+
+        if (nstrips < 2) {
+            if (read_window(m_band, x0, y0, nx, ny, buf)) {
+                throw std::runtime_error("Error reading from raster.");
+            }
+            return;
+        }
+
+        // Divide the window into strips made up of whole rows of blocks, so
+        // that each block is decoded by exactly one thread.
+        int blocks_per_strip = (nblocks + static_cast<int>(nstrips) - 1) / static_cast<int>(nstrips);
+
+        std::vector<std::pair<int, int>> strips;
+        for (int b = first_block; b <= last_block; b += blocks_per_strip) {
+            int row_begin = std::max(y0, b * block_rows);
+            int row_end = std::min(y0 + ny, (b + blocks_per_strip) * block_rows);
+
+            strips.emplace_back(row_begin, row_end - row_begin);
+        }
+
+        // Open any needed handles before starting threads, so that a failure
+        // can be reported with an exception.
+        std::vector<GDALRasterBandH> bands{m_band};
+        for (size_t i = 1; i < strips.size(); i++) {
+            bands.push_back(worker_band(i - 1));
+        }
+
+        std::vector<CPLErr> errors(strips.size(), CE_None);
+        std::vector<std::thread> threads;
+
+        for (size_t i = 1; i < strips.size(); i++) {
+            threads.emplace_back([&, i]() {
+                errors[i] = read_window(bands[i], x0, strips[i].first, nx, strips[i].second,
+                                        buf + static_cast<size_t>(strips[i].first - y0) * static_cast<size_t>(nx));
+            });
+        }
+
+        errors[0] = read_window(bands[0], x0, strips[0].first, nx, strips[0].second, buf);
+
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        for (const auto& error : errors) {
+            if (error) {
+                throw std::runtime_error("Error reading from raster.");
+            }
+        }
+    }
+
+    GDALRasterWrapper::GDALRasterBandH GDALRasterWrapper::worker_band(size_t i) {
+        while (m_worker_rasters.size() <= i) {
+            auto rast = GDALOpen(m_filename.c_str(), GA_ReadOnly);
+            if (!rast) {
+                throw std::runtime_error("Failed to open " + m_filename);
+            }
+            m_worker_rasters.push_back(rast);
+        }
+
+        return GDALGetRasterBand(m_worker_rasters[i], m_bandnum);
+    }
+
     void GDALRasterWrapper::compute_raster_grid() {
         double adfGeoTransform[6];
         if (GDALGetGeoTransform(m_rast, adfGeoTransform) != CE_None) {
@@ -99,8 +190,13 @@ namespace exactextract {
         m_band{src.m_band},
         m_nodata_value{src.m_nodata_value},
         m_has_nodata{src.m_has_nodata},
-        m_grid{src.m_grid} {
+        m_grid{src.m_grid},
+        m_filename{std::move(src.m_filename)},
+        m_bandnum{src.m_bandnum},
+        m_read_threads{src.m_read_threads},
+        m_worker_rasters{std::move(src.m_worker_rasters)} {
         src.m_rast = nullptr;
+        src.m_worker_rasters.clear();
     }
 
 }
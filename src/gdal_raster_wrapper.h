@@ -14,6 +14,10 @@
 #ifndef EXACTEXTRACT_GDAL_RASTER_WRAPPER_H
 #define EXACTEXTRACT_GDAL_RASTER_WRAPPER_H
 
+#include <string>
+#include <utility>
+#include <vector>
+
 #include "box.h"
 #include "grid.h"
 #include "raster.h"
@@ -33,6 +37,22 @@ namespace exactextract {
 
         std::unique_ptr<AbstractRaster<double>> read_box(const Box &box) override;
 
+        /**
+         * Set the number of threads used to decode a single call to read_box.
+         * When greater than one, windows spanning multiple rows of blocks are
+         * split into block-aligned strips that are read concurrently, each
+         * through a separate dataset handle.
+         */
+        void set_read_threads(size_t n) {
+            m_read_threads = n;
+        }
+
+        /** Return the spatial reference system of the raster, as WKT. */
+        std::string projection() const;
+
+        /** Return the number of rows and columns in the natural block size of the band. */
+        std::pair<size_t, size_t> block_size() const;
+
         ~GDALRasterWrapper() override;
 
         GDALRasterWrapper(const GDALRasterWrapper &) = delete;
@@ -46,8 +66,16 @@ namespace exactextract {
         double m_nodata_value;
         bool m_has_nodata;
         Grid<bounded_extent> m_grid;
+        std::string m_filename;
+        int m_bandnum;
+        size_t m_read_threads;
+        std::vector<GDALDatasetH> m_worker_rasters;
 
         void compute_raster_grid();
+
+        void read_parallel(int x0, int y0, int nx, int ny, double* buf);
+
+        GDALRasterBandH worker_band(size_t i);
     };
 }
 
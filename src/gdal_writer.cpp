@@ -18,6 +18,7 @@
 
 #include "gdal.h"
 #include "ogr_api.h"
+#include "cpl_conv.h"
 #include "cpl_string.h"
 
 #include <stdexcept>
@@ -32,30 +33,71 @@ namespace exactextract {
             throw std::runtime_error("Could not load output driver: " + driver_name);
         }
 
+        char** creation_options = nullptr;
         char** layer_creation_options = nullptr;
         if (driver_name == "NetCDF") {
             //creation_options = CSLSetNameValue(creation_options, "FORMAT", "NC3"); // crashes w/NC4C
             layer_creation_options = CSLSetNameValue(layer_creation_options, "RECORD_DIM_NAME", "id");
+        } else if (driver_name == "GPKG") {
+            // Output has no geometry, so skip the tables that describe it.
+            creation_options = CSLSetNameValue(creation_options, "METADATA_TABLES", "NO");
+        } else if (driver_name == "SQLite") {
+            creation_options = CSLSetNameValue(creation_options, "METADATA", "NO");
         }
 
-        m_dataset = GDALCreate(driver, filename.c_str(), 0, 0, 0, GDT_Unknown, nullptr);
-        m_layer = GDALDatasetCreateLayer(m_dataset, "output", nullptr, wkbNone, layer_creation_options);
+        // Columnar formats have a representation of missing values that
+        // readers such as pandas understand, so leave fields without a
+        // result unset (null) instead of writing NaN.
+        m_null_results = driver_name == "Arrow" || driver_name == "Parquet";
+
+        // The output is written once, from start to finish, so there is
+        // no need to sync each transaction to disk or to use INSERT rather
+        // than COPY. Settings made by the user are left unchanged.
+        if (driver_name == "GPKG" || driver_name == "SQLite") {
+            if (CPLGetConfigOption("OGR_SQLITE_SYNCHRONOUS", nullptr) == nullptr) {
+                CPLSetConfigOption("OGR_SQLITE_SYNCHRONOUS", "OFF");
+            }
+        } else if (driver_name == "PostgreSQL") {
+            if (CPLGetConfigOption("PG_USE_COPY", nullptr) == nullptr) {
+                CPLSetConfigOption("PG_USE_COPY", "YES");
+            }
+        }
+
+        m_dataset = GDALCreate(driver, filename.c_str(), 0, 0, 0, GDT_Unknown, creation_options);
+        CSLDestroy(creation_options);
+
+        if (m_dataset == nullptr) {
+            CSLDestroy(layer_creation_options);
+            throw std::runtime_error("Could not create output: " + filename);
+        }
 
+        m_layer = GDALDatasetCreateLayer(m_dataset, "output", nullptr, wkbNone, layer_creation_options);
         CSLDestroy(layer_creation_options);
+
+        m_transactions = OGR_L_TestCapability(m_layer, OLCTransactions);
     }
 
     GDALWriter::~GDALWriter() {
+        if (m_in_transaction) {
+            // finish() was not called, probably because of an error, so
+            // commit whatever was written without throwing.
+            OGR_L_CommitTransaction(m_layer);
+        }
         if (m_dataset != nullptr) {
             GDALClose(m_dataset);
         }
     }
 
     void GDALWriter::copy_id_field(const GDALDatasetWrapper & w) {
+        copy_id_field(w, w.id_field());
+    }
+
+    void GDALWriter::copy_id_field(const GDALDatasetWrapper & w, const std::string & field_name) {
         if (id_field_defined) {
             throw std::runtime_error("ID field already defined.");
         }
 
-        w.copy_field(w.id_field(), m_layer);
+        w.copy_field(field_name, m_layer);
         id_field_defined = true;
     }
 
@@ -90,6 +132,9 @@ namespace exactextract {
 
         // TODO set type here?
         auto def = OGR_Fld_Create(op.name.c_str(), OFTReal);
+        if (m_single_precision) {
+            OGR_Fld_SetSubType(def, OFSTFloat32);
+        }
         OGR_L_CreateField(m_layer, def, true);
         OGR_Fld_Destroy(def);
 
@@ -100,10 +145,21 @@ namespace exactextract {
         m_reg = reg;
     }
 
-    void GDALWriter::write(const std::string & fid) {
+    void GDALWriter::write(const FeatureId & fid) {
+        if (m_transactions && !m_in_transaction) {
+            if (OGR_L_StartTransaction(m_layer) != OGRERR_NONE) {
+                throw std::runtime_error("Error starting transaction.");
+            }
+            m_in_transaction = true;
+        }
+
         auto feature = OGR_F_Create(OGR_L_GetLayerDefn(m_layer));
 
-        OGR_F_SetFieldString(feature, 0, fid.c_str());
+        if (fid.is_int()) {
+            OGR_F_SetFieldInteger64(feature, 0, fid.as_int());
+        } else {
+            OGR_F_SetFieldString(feature, 0, fid.as_string().c_str());
+        }
 
         for (const auto &op : m_ops) {
             if (m_reg->contains(fid, *op)) {
@@ -116,25 +172,52 @@ namespace exactextract {
                 auto val = fetcher(stats);
                 if (val.has_value()) {
                     OGR_F_SetFieldDouble(feature, field_pos, val.value());
-                } else {
+                } else if (!m_null_results) {
                     OGR_F_SetFieldDouble(feature, field_pos, std::numeric_limits<double>::quiet_NaN());
                 }
             }
         }
 
         if (OGR_L_CreateFeature(m_layer, feature) != OGRERR_NONE) {
-            throw std::runtime_error("Error writing results for record: " + fid);
+            throw std::runtime_error("Error writing results for record: " + fid.to_string());
         }
         OGR_F_Destroy(feature);
+
+        if (m_in_transaction && ++m_batch_count >= m_batch_size) {
+            commit();
+        }
+    }
+
+    void GDALWriter::finish() {
+        if (m_in_transaction) {
+            commit();
+        }
+    }
+
+    void GDALWriter::commit() {
+        m_in_transaction = false;
+        m_batch_count = 0;
+
+        if (OGR_L_CommitTransaction(m_layer) != OGRERR_NONE) {
+            throw std::runtime_error("Error committing transaction.");
+        }
     }
 
     std::string GDALWriter::get_driver_name(const std::string & filename) {
-        if (ends_with(filename, ".csv")) {
+        if (ends_with(filename, ".arrow") || ends_with(filename, ".feather")) {
+            return "Arrow";
+        } else if (ends_with(filename, ".csv")) {
             return "CSV";
         } else if (ends_with(filename, ".dbf")) {
             return "ESRI Shapefile";
+        } else if (ends_with(filename, ".gpkg")) {
+            return "GPKG";
         } else if (ends_with(filename, ".nc")) {
             return "NetCDF";
+        } else if (ends_with(filename, ".sqlite")) {
+            return "SQLite";
+        } else if (ends_with(filename, ".parquet")) {
+            return "Parquet";
         } else if (starts_with(filename, "PG:")) {
             return "PostgreSQL";
         } else {
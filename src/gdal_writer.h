@@ -33,19 +33,50 @@ namespace exactextract {
 
         void set_registry(const StatsRegistry* reg) override;
 
-        void write(const std::string & fid) override;
+        void write(const FeatureId & fid) override;
+
+        /** Commit any features written since the last batch. */
+        void finish() override;
+
+        /**
+         * For drivers that support transactions, write features in
+         * transactions of `size` features rather than one transaction
+         * per feature.
+         */
+        void set_batch_size(size_t size) {
+            m_batch_size = size;
+        }
+
+        /**
+         * Store results as single-precision floating-point values, for
+         * drivers that support them.
+         */
+        void set_single_precision(bool val) {
+            m_single_precision = val;
+        }
 
         void add_id_field(const std::string & field_name, const std::string & field_type);
 
         void copy_id_field(const GDALDatasetWrapper & w);
 
+        /** Define the ID field as a copy of the field `field_name` of `w`. */
+        void copy_id_field(const GDALDatasetWrapper & w, const std::string & field_name);
+
     private:
         using GDALDatasetH = void*;
         using OGRLayerH = void*;
 
+        void commit();
+
         GDALDatasetH m_dataset;
         OGRLayerH m_layer;
         const StatsRegistry* m_reg;
+        size_t m_batch_size = 10000;
+        size_t m_batch_count = 0;
+        bool m_transactions = false;
+        bool m_in_transaction = false;
+        bool m_null_results = false;
+        bool m_single_precision = false;
         bool id_field_defined = false;
     };
 
@@ -0,0 +1,96 @@
+// Copyright (c) 2021 ISciences, LLC.
+// All rights reserved.
+//
+// This software is licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License. You may
+// obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0.
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "hilbert.h"
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <utility>
+
+namespace exactextract {
+
+    uint32_t hilbert_index(uint32_t x, uint32_t y, uint32_t bits) {
+        // https://en.wikipedia.org/wiki/Hilbert_curve#Applications_and_mapping_algorithms
+        const uint32_t n = 1u << bits;
+
+        uint32_t d = 0;
+        for (uint32_t s = n / 2; s > 0; s /= 2) {
+            uint32_t rx = (x & s) > 0;
+            uint32_t ry = (y & s) > 0;
+
+            d += s * s * ((3 * rx) ^ ry);
+
+            if (ry == 0) {
+                if (rx == 1) {
+                    x = n - 1 - x;
+                    y = n - 1 - y;
+                }
+                std::swap(x, y);
+            }
+        }
+
+        return d;
+    }
+
+    std::vector<size_t> hilbert_order(const std::vector<Box> & boxes) {
+        constexpr uint32_t bits = 16;
+        constexpr double max_coord = static_cast<double>((1u << bits) - 1);
+
+        Box extent{std::numeric_limits<double>::max(),
+                   std::numeric_limits<double>::max(),
+                   std::numeric_limits<double>::lowest(),
+                   std::numeric_limits<double>::lowest()};
+
+        for (const auto& box : boxes) {
+            if (!(box == Box::make_empty())) {
+                extent.xmin = std::min(extent.xmin, box.xmin);
+                extent.ymin = std::min(extent.ymin, box.ymin);
+                extent.xmax = std::max(extent.xmax, box.xmax);
+                extent.ymax = std::max(extent.ymax, box.ymax);
+            }
+        }
+
+        std::vector<uint64_t> keys(boxes.size());
+        for (size_t i = 0; i < boxes.size(); i++) {
+            const Box& box = boxes[i];
+
+            // Degenerate envelopes (points, or horizontal or vertical lines) still
+            // have a meaningful position, but those of null geometries do not.
+            if (box == Box::make_empty()) {
+                keys[i] = std::numeric_limits<uint64_t>::max();
+                continue;
+            }
+
+            double cx = 0.5 * (box.xmin + box.xmax);
+            double cy = 0.5 * (box.ymin + box.ymax);
+
+            double fx = extent.width() > 0 ? (cx - extent.xmin) / extent.width() : 0;
+            double fy = extent.height() > 0 ? (cy - extent.ymin) / extent.height() : 0;
+
+            auto x = static_cast<uint32_t>(std::max(0.0, std::min(max_coord, fx * max_coord)));
+            auto y = static_cast<uint32_t>(std::max(0.0, std::min(max_coord, fy * max_coord)));
+
+            keys[i] = hilbert_index(x, y, bits);
+        }
+
+        std::vector<size_t> order(boxes.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [&keys](size_t a, size_t b) {
+            return keys[a] < keys[b];
+        });
+
+        return order;
+    }
+
+}
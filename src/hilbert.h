@@ -0,0 +1,39 @@
+// Copyright (c) 2021 ISciences, LLC.
+// All rights reserved.
+//
+// This software is licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License. You may
+// obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0.
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef EXACTEXTRACT_HILBERT_H
+#define EXACTEXTRACT_HILBERT_H
+
+#include <cstdint>
+#include <vector>
+
+#include "box.h"
+
+namespace exactextract {
+
+    /**
+     * Return the distance along a Hilbert curve of the cell (x, y)
+     * in a square grid with 2^bits cells on each side.
+     */
+    uint32_t hilbert_index(uint32_t x, uint32_t y, uint32_t bits = 16);
+
+    /**
+     * Return the indices of the supplied boxes, ordered by the position
+     * of their centers along a Hilbert curve covering the extent of all
+     * boxes. Empty boxes are placed at the end.
+     */
+    std::vector<size_t> hilbert_order(const std::vector<Box> & boxes);
+
+}
+
+#endif //EXACTEXTRACT_HILBERT_H
@@ -0,0 +1,96 @@
+// Copyright (c) 2020 ISciences, LLC.
+// All rights reserved.
+//
+// This software is licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License. You may
+// obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0.
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef EXACTEXTRACT_IN_MEMORY_RASTER_SOURCE_H
+#define EXACTEXTRACT_IN_MEMORY_RASTER_SOURCE_H
+
+#include <memory>
+
+#include "grid.h"
+#include "raster.h"
+#include "raster_source.h"
+
+namespace exactextract {
+
+    /**
+     * A read-only view of a window of a row-major buffer of values owned by
+     * the caller. Values are converted to double as they are accessed.
+     */
+    template<typename T>
+    class BufferRasterView : public AbstractRaster<double> {
+    public:
+        BufferRasterView(const T* data, const Grid<bounded_extent> & ex, size_t stride) :
+            AbstractRaster<double>(ex),
+            m_data{data},
+            m_stride{stride} {}
+
+        double operator()(size_t row, size_t col) const override {
+            return static_cast<double>(m_data[row*m_stride + col]);
+        }
+
+    private:
+        const T* m_data;
+        size_t m_stride;
+    };
+
+    /**
+     * A RasterSource backed by a buffer of values that has already been
+     * loaded into memory by the caller. The buffer must be stored in
+     * row-major order, must have the same dimensions as the supplied grid,
+     * and must outlive the InMemoryRasterSource and any rasters returned
+     * by read_box, which refer to the buffer without copying it.
+     */
+    template<typename T>
+    class InMemoryRasterSource : public RasterSource {
+    public:
+        InMemoryRasterSource(const T* data, const Grid<bounded_extent> & grid) :
+            m_data{data},
+            m_grid{grid},
+            m_nodata{},
+            m_has_nodata{false} {}
+
+        InMemoryRasterSource(const T* data, const Grid<bounded_extent> & grid, const T & nodata) :
+            m_data{data},
+            m_grid{grid},
+            m_nodata{nodata},
+            m_has_nodata{true} {}
+
+        const Grid<bounded_extent> &grid() const override {
+            return m_grid;
+        }
+
+        std::unique_ptr<AbstractRaster<double>> read_box(const Box &box) override {
+            auto cropped_grid = m_grid.shrink_to_fit(box);
+
+            size_t row0 = cropped_grid.row_offset(m_grid);
+            size_t col0 = cropped_grid.col_offset(m_grid);
+
+            auto view = std::make_unique<BufferRasterView<T>>(m_data + row0*m_grid.cols() + col0, cropped_grid, m_grid.cols());
+
+            if (m_has_nodata) {
+                view->set_nodata(static_cast<double>(m_nodata));
+            }
+
+            return view;
+        }
+
+    private:
+        const T* m_data;
+        Grid<bounded_extent> m_grid;
+        T m_nodata;
+        bool m_has_nodata;
+    };
+
+}
+
+#endif //EXACTEXTRACT_IN_MEMORY_RASTER_SOURCE_H
@@ -35,6 +35,14 @@ namespace exactextract {
             return weights != nullptr;
         }
 
+        /**
+         * Returns true if this operation requires the coverage of each distinct
+         * raster value to be retained, rather than only summary accumulators.
+         */
+        bool requires_stored_values() const {
+            return stat == "majority" || stat == "mode" || stat == "minority" || stat == "variety";
+        }
+
         Grid<bounded_extent> grid() const {
             if (weighted()) {
                 return values->grid().common_grid(weights->grid());
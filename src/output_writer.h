@@ -17,6 +17,8 @@
 #include <string>
 #include <vector>
 
+#include "feature_id.h"
+
 namespace exactextract {
 
     class Operation;
@@ -24,7 +26,7 @@ namespace exactextract {
 
     class OutputWriter {
     public:
-        virtual void write(const std::string & fid) = 0;
+        virtual void write(const FeatureId & fid) = 0;
         virtual void add_operation(const Operation & op) = 0;
         virtual void set_registry(const StatsRegistry* reg) = 0;
 
@@ -0,0 +1,113 @@
+// Copyright (c) 2020 ISciences, LLC.
+// All rights reserved.
+//
+// This software is licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License. You may
+// obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0.
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "hilbert.h"
+#include "packed_rtree.h"
+
+namespace exactextract {
+
+    PackedRTree::PackedRTree(const std::vector<Box> & boxes, size_t node_size) :
+        m_num_items{0},
+        m_node_size{node_size}
+    {
+        if (m_node_size < 2) {
+            throw std::invalid_argument("R-tree node size must be at least 2.");
+        }
+
+        for (size_t i : hilbert_order(boxes)) {
+            // Empty boxes are sorted last
+            if (boxes[i] == Box::make_empty()) {
+                break;
+            }
+
+            add_node(boxes[i], i);
+            m_num_items++;
+        }
+
+        if (m_num_items == 0) {
+            return;
+        }
+
+        m_level_bounds.push_back(m_num_items);
+
+        size_t level_start = 0;
+        size_t level_end = m_num_items;
+
+        // Always add at least one level above the leaves, so that the root is
+        // never a leaf.
+        do {
+            for (size_t pos = level_start; pos < level_end; pos += m_node_size) {
+                size_t end = std::min(pos + m_node_size, level_end);
+
+                Box bounds{m_xmin[pos], m_ymin[pos], m_xmax[pos], m_ymax[pos]};
+                for (size_t child = pos + 1; child < end; child++) {
+                    bounds.xmin = std::min(bounds.xmin, m_xmin[child]);
+                    bounds.ymin = std::min(bounds.ymin, m_ymin[child]);
+                    bounds.xmax = std::max(bounds.xmax, m_xmax[child]);
+                    bounds.ymax = std::max(bounds.ymax, m_ymax[child]);
+                }
+
+                add_node(bounds, pos);
+            }
+
+            level_start = level_end;
+            level_end = m_indices.size();
+            m_level_bounds.push_back(level_end);
+        } while (level_end - level_start > 1);
+    }
+
+    void PackedRTree::add_node(const Box & box, size_t index) {
+        m_xmin.push_back(box.xmin);
+        m_ymin.push_back(box.ymin);
+        m_xmax.push_back(box.xmax);
+        m_ymax.push_back(box.ymax);
+        m_indices.push_back(index);
+    }
+
+    void PackedRTree::query(const Box & query, std::vector<size_t> & out) const {
+        out.clear();
+
+        if (m_num_items == 0) {
+            return;
+        }
+
+        // Positions of nodes whose children remain to be checked
+        std::vector<size_t> stack{m_indices.size() - 1};
+
+        while (!stack.empty()) {
+            size_t node = stack.back();
+            stack.pop_back();
+
+            size_t first_child = m_indices[node];
+            size_t level_end = *std::upper_bound(m_level_bounds.begin(), m_level_bounds.end(), first_child);
+            size_t end = std::min(first_child + m_node_size, level_end);
+
+            for (size_t pos = first_child; pos < end; pos++) {
+                if (query.xmax < m_xmin[pos] || query.xmin > m_xmax[pos] ||
+                    query.ymax < m_ymin[pos] || query.ymin > m_ymax[pos]) {
+                    continue;
+                }
+
+                if (pos < m_num_items) {
+                    out.push_back(m_indices[pos]);
+                } else {
+                    stack.push_back(pos);
+                }
+            }
+        }
+    }
+
+}
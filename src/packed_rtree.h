@@ -0,0 +1,82 @@
+// Copyright (c) 2020 ISciences, LLC.
+// All rights reserved.
+//
+// This software is licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License. You may
+// obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0.
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef EXACTEXTRACT_PACKED_RTREE_H
+#define EXACTEXTRACT_PACKED_RTREE_H
+
+#include <cstddef>
+#include <vector>
+
+#include "box.h"
+
+namespace exactextract {
+
+    /**
+     * A static R-tree of boxes, bulk-loaded once by sorting the boxes along a
+     * Hilbert curve and packing them into nodes of a fixed size. Node bounds
+     * are stored level by level in parallel arrays, leaves first, so the
+     * tree requires no per-node allocations.
+     */
+    class PackedRTree {
+    public:
+        PackedRTree() : m_num_items{0}, m_node_size{16} {}
+
+        /**
+         * Construct a tree of the supplied boxes. Boxes equal to Box::make_empty()
+         * (as used for null geometries) are not indexed.
+         */
+        explicit PackedRTree(const std::vector<Box> & boxes, size_t node_size = 16);
+
+        /**
+         * Replace `out` with the indices (in the vector supplied to the
+         * constructor) of the boxes that intersect `query`.
+         */
+        void query(const Box & query, std::vector<size_t> & out) const;
+
+        std::vector<size_t> query(const Box & query) const {
+            std::vector<size_t> out;
+            this->query(query, out);
+            return out;
+        }
+
+        /** Return the number of indexed boxes. */
+        size_t size() const {
+            return m_num_items;
+        }
+
+        bool empty() const {
+            return m_num_items == 0;
+        }
+
+    private:
+        void add_node(const Box & box, size_t index);
+
+        size_t m_num_items;
+        size_t m_node_size;
+
+        std::vector<double> m_xmin;
+        std::vector<double> m_ymin;
+        std::vector<double> m_xmax;
+        std::vector<double> m_ymax;
+
+        // For leaves, the index of the item; for other nodes, the position
+        // of the node's first child.
+        std::vector<size_t> m_indices;
+
+        // One past the position of the last node in each level
+        std::vector<size_t> m_level_bounds;
+    };
+
+}
+
+#endif
@@ -17,6 +17,7 @@
 #include <iostream>
 #include <string>
 
+#include "cell_writer.h"
 #include "gdal_dataset_wrapper.h"
 #include "output_writer.h"
 #include "stats_registry.h"
@@ -35,6 +36,10 @@ namespace exactextract {
                 m_operations{ops}
         {
             m_output.set_registry(&m_reg);
+
+            for (const auto& op : m_operations) {
+                m_reg.add_operation(op);
+            }
         }
 
         virtual ~Processor() {
@@ -51,6 +56,14 @@ namespace exactextract {
             m_show_progress = val;
         }
 
+        /**
+         * Also write each cell covered by each feature, with its coverage
+         * fraction and raster values, to `writer`.
+         */
+        void set_cell_writer(CellWriter* writer) {
+            m_cell_writer = writer;
+        }
+
     protected:
 
         template<typename T>
@@ -70,6 +83,8 @@ namespace exactextract {
 
         OutputWriter& m_output;
 
+        CellWriter* m_cell_writer = nullptr;
+
         GDALDatasetWrapper& m_shp;
 
         bool store_values=false;
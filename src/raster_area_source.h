@@ -0,0 +1,105 @@
+// Copyright (c) 2021 ISciences, LLC.
+// All rights reserved.
+//
+// This software is licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License. You may
+// obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0.
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef EXACTEXTRACT_RASTER_AREA_SOURCE_H
+#define EXACTEXTRACT_RASTER_AREA_SOURCE_H
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "raster_area.h"
+#include "raster_source.h"
+
+namespace exactextract {
+
+    /**
+     * A raster whose value depends only on the row, read from a
+     * vector of per-row values owned by someone else.
+     */
+    class RowValueRaster : public AbstractRaster<double> {
+    public:
+        RowValueRaster(const Grid<bounded_extent> & ex, const double* row_values) :
+            AbstractRaster<double>(ex),
+            m_row_values{row_values} {}
+
+        double operator()(size_t row, size_t col) const override {
+            (void) col;
+            return m_row_values[row];
+        }
+
+    private:
+        const double* m_row_values;
+    };
+
+    /**
+     * A virtual RasterSource providing the area of each cell in a grid,
+     * computed either in the units of the grid (Cartesian) or in square
+     * meters, treating the grid as geographic coordinates on a sphere.
+     * Because cell area varies only by row, areas are computed once per
+     * row of the grid and windows returned by read_box refer to them
+     * without performing any I/O.
+     */
+    class AreaRasterSource : public RasterSource {
+    public:
+        enum class Method {
+            CARTESIAN,
+            SPHERICAL
+        };
+
+        AreaRasterSource(const Grid<bounded_extent> & grid, Method method) :
+            m_grid{grid},
+            m_row_areas(grid.rows())
+        {
+            if (method == Method::SPHERICAL) {
+                SphericalAreaRaster<double> areas(m_grid);
+                for (size_t i = 0; i < m_grid.rows(); i++) {
+                    m_row_areas[i] = areas(i, 0);
+                }
+            } else if (!m_grid.empty()) {
+                CartesianAreaRaster<double> areas(m_grid);
+                for (size_t i = 0; i < m_grid.rows(); i++) {
+                    m_row_areas[i] = areas(i, 0);
+                }
+            }
+        }
+
+        static Method parse_method(const std::string & name) {
+            if (name == "cartesian_area") {
+                return Method::CARTESIAN;
+            } else if (name == "spherical_area") {
+                return Method::SPHERICAL;
+            } else {
+                throw std::runtime_error("Unknown virtual raster: " + name);
+            }
+        }
+
+        const Grid<bounded_extent> &grid() const override {
+            return m_grid;
+        }
+
+        std::unique_ptr<AbstractRaster<double>> read_box(const Box &box) override {
+            auto cropped_grid = m_grid.shrink_to_fit(box);
+
+            return std::make_unique<RowValueRaster>(cropped_grid, m_row_areas.data() + cropped_grid.row_offset(m_grid));
+        }
+
+    private:
+        Grid<bounded_extent> m_grid;
+        std::vector<double> m_row_areas;
+    };
+
+}
+
+#endif //EXACTEXTRACT_RASTER_AREA_SOURCE_H
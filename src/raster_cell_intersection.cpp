@@ -23,6 +23,8 @@
 
 namespace exactextract {
 
+    static constexpr size_t max_clipped_cells = 16;
+
     Raster<float> raster_cell_intersection(const Grid<bounded_extent> & raster_grid, GEOSContextHandle_t context, const GEOSGeometry* g) {
         RasterCellIntersection rci(raster_grid, context, g);
 
@@ -30,6 +32,13 @@ namespace exactextract {
                  make_finite(rci.m_geometry_grid) };
     }
 
+    Raster<float> raster_cell_intersection(const Grid<bounded_extent> & raster_grid, const FlatGeometry & g) {
+        RasterCellIntersection rci(raster_grid, g);
+
+        return { std::move(const_cast<Matrix<float>&>(rci.overlap_areas())),
+                 make_finite(rci.m_geometry_grid) };
+    }
+
     Raster<float> raster_cell_intersection(const Grid<bounded_extent> & raster_grid, const Box & box) {
         RasterCellIntersection rci(raster_grid, box);
 
@@ -84,6 +93,20 @@ namespace exactextract {
         }
     }
 
+    static Grid<infinite_extent> get_geometry_grid(const Grid<bounded_extent> &raster_grid, const FlatGeometry & g) {
+        if (g.empty()) {
+            throw std::invalid_argument("Can't get statistics for empty geometry");
+        }
+
+        Box region = processing_region(raster_grid.extent(), g.component_boxes());
+
+        if (!region.empty()) {
+            return make_infinite(raster_grid.shrink_to_fit(region));
+        } else {
+            return Grid<infinite_extent>::make_empty();
+        }
+    }
+
     static Grid<infinite_extent> get_geometry_grid(const Grid<bounded_extent> & raster_grid, const Box & box) {
         auto region = box.intersection(raster_grid.extent());
 
@@ -103,6 +126,14 @@ namespace exactextract {
             process(context, g);
     }
 
+    RasterCellIntersection::RasterCellIntersection(const Grid<bounded_extent> &raster_grid, const FlatGeometry &g)
+        : m_geometry_grid{get_geometry_grid(raster_grid, g)},
+          m_overlap_areas{std::make_unique<Matrix<float>>(m_geometry_grid.rows() - 2, m_geometry_grid.cols() - 2)}
+    {
+        if (!m_geometry_grid.empty())
+            process(g);
+    }
+
     RasterCellIntersection::RasterCellIntersection(const Grid<bounded_extent> & raster_grid, const Box & box)
         : m_geometry_grid{get_geometry_grid(raster_grid, box)},
           m_overlap_areas{std::make_unique<Matrix<float>>(m_geometry_grid.rows() - 2, m_geometry_grid.cols() - 2)} {
@@ -129,15 +160,19 @@ namespace exactextract {
         }
     }
 
+    void RasterCellIntersection::process(const FlatGeometry &g) {
+        for (size_t i = 0; i < g.num_polygons(); i++) {
+            for (size_t j = g.first_ring(i); j < g.end_ring(i); j++) {
+                process_ring(g.ring(j), j == g.first_ring(i));
+            }
+        }
+    }
+
     static Grid<infinite_extent> get_box_grid(const Box & box, const Grid<infinite_extent> & geometry_grid) {
         Box cropped_ring_extent = geometry_grid.extent().intersection(box);
         return geometry_grid.shrink_to_fit(cropped_ring_extent);
     }
 
-    static Grid<infinite_extent> get_ring_grid(GEOSContextHandle_t context, const GEOSGeometry* ls, const Grid<infinite_extent> & geometry_grid) {
-        return get_box_grid(geos_get_box(context, ls), geometry_grid);
-    }
-
     void RasterCellIntersection::process_rectangular_ring(const Box& box, bool exterior_ring) {
         if (!box.intersects(m_geometry_grid.extent())) {
             return;
@@ -228,24 +263,30 @@ namespace exactextract {
     }
 
     void RasterCellIntersection::process_ring(GEOSContextHandle_t context, const GEOSGeometry *ls, bool exterior_ring) {
-        auto geom_box = geos_get_box(context, ls);
+        auto coords = read(context, GEOSGeom_getCoordSeq_r(context, ls));
 
-        if (!geom_box.intersects(m_geometry_grid.extent())) {
+        process_ring(CoordinateRange(coords), exterior_ring);
+    }
+
+    void RasterCellIntersection::process_ring(const CoordinateRange &ring, bool exterior_ring) {
+        if (ring.empty()) {
             return;
         }
 
-        const GEOSCoordSequence *seq = GEOSGeom_getCoordSeq_r(context, ls);
-        unsigned int npoints = geos_get_num_points(context, seq);
+        auto geom_box = ring_box(ring);
 
-        if (npoints == 5) {
-            auto coords = read(context, seq);
-            if (area(coords) == geom_box.area()) {
+        if (!geom_box.intersects(m_geometry_grid.extent())) {
+            return;
+        }
+
+        if (ring.size() == 5) {
+            if (area(ring) == geom_box.area()) {
                 process_rectangular_ring(geom_box, exterior_ring);
                 return;
             }
         }
 
-        Grid<infinite_extent> ring_grid = get_ring_grid(context, ls, m_geometry_grid);
+        Grid<infinite_extent> ring_grid = get_box_grid(geom_box, m_geometry_grid);
 
         size_t rows = ring_grid.rows();
         size_t cols = ring_grid.cols();
@@ -256,8 +297,7 @@ namespace exactextract {
             cols == (1 + 2*infinite_extent::padding) &&
             grid_cell(ring_grid, 1, 1).contains(geom_box)) {
 
-            auto coords = read(context, seq);
-            auto ring_area = area(coords) / grid_cell(ring_grid, 1, 1).area();
+            auto ring_area = area(ring) / grid_cell(ring_grid, 1, 1).area();
 
             size_t i0 = ring_grid.row_offset(m_geometry_grid);
             size_t j0 = ring_grid.col_offset(m_geometry_grid);
@@ -271,29 +311,38 @@ namespace exactextract {
             return;
         }
 
-        bool is_ccw = geos_is_ccw(context, seq);
-        Matrix<std::unique_ptr<Cell>> cells(rows, cols);
+        // For rings spanning only a few cells, clipping the ring to each cell
+        // is cheaper than traversing it and flood-filling the result.
+        if ((rows - 2*infinite_extent::padding) * (cols - 2*infinite_extent::padding) <= max_clipped_cells) {
+            std::vector<Coordinate> scratch;
+            scratch.reserve(ring.size() + 8);
 
-        std::deque<Coordinate> stk;
-        {
-            for (unsigned int i = 0; i < npoints; i++) {
-                double x, y;
-#if HAVE_380
-                if (!GEOSCoordSeq_getXY_r(context, seq, i, &x, &y)) {
-                    throw std::runtime_error("Error reading coordinates.");
-                }
-#else
-                if (!GEOSCoordSeq_getX_r(context, seq, i, &x) || !GEOSCoordSeq_getY_r(context, seq, i, &y)) {
-                    throw std::runtime_error("Error reading coordinates.");
-                }
-#endif
+            size_t i0 = ring_grid.row_offset(m_geometry_grid);
+            size_t j0 = ring_grid.col_offset(m_geometry_grid);
+            float factor = exterior_ring ? 1.0f : -1.0f;
 
-                if (is_ccw) {
-                    stk.emplace_back(x, y);
-                } else {
-                    stk.emplace_front(x, y);
+            for (size_t i = 1; i < rows - 1; i++) {
+                for (size_t j = 1; j < cols - 1; j++) {
+                    Box cell = grid_cell(ring_grid, i, j);
+                    auto frac = static_cast<float>(clipped_area(ring, cell, scratch) / cell.area());
+                    m_overlap_areas->increment(i0 + i - 1, j0 + j - 1, factor * frac);
                 }
             }
+
+            return;
+        }
+
+        // area_signed is negative for counter-clockwise rings
+        bool is_ccw = area_signed(ring) < 0;
+        Matrix<std::unique_ptr<Cell>> cells(rows, cols);
+
+        std::deque<Coordinate> stk;
+        for (const auto& c : ring) {
+            if (is_ccw) {
+                stk.push_back(c);
+            } else {
+                stk.push_front(c);
+            }
         }
 
         size_t row = ring_grid.get_row(stk.front().y);
@@ -357,7 +406,7 @@ namespace exactextract {
         // TODO avoid copying matrix when geometry has only one polygon, and polygon has only one ring
         Matrix<float> areas(rows - 2, cols - 2, fill_values<float>::FILLABLE);
 
-        FloodFill ff(context, ls, make_finite(ring_grid));
+        FloodFill ff(ring, make_finite(ring_grid));
 
         for (size_t i = 1; i <= areas.rows(); i++) {
             for (size_t j = 1; j <= areas.cols(); j++) {
@@ -18,6 +18,7 @@
 
 #include <geos_c.h>
 
+#include "flat_geometry.h"
 #include "grid.h"
 #include "matrix.h"
 #include "raster.h"
@@ -29,6 +30,8 @@ namespace exactextract {
     public:
         RasterCellIntersection(const Grid<bounded_extent> &raster_grid, GEOSContextHandle_t context, const GEOSGeometry *g);
 
+        RasterCellIntersection(const Grid<bounded_extent> &raster_grid, const FlatGeometry &g);
+
         RasterCellIntersection(const Grid<bounded_extent> &raster_grid, const Box & box);
 
         size_t rows() const { return m_overlap_areas->rows(); }
@@ -41,8 +44,12 @@ namespace exactextract {
     private:
         void process(GEOSContextHandle_t context, const GEOSGeometry *g);
 
+        void process(const FlatGeometry &g);
+
         void process_ring(GEOSContextHandle_t context, const GEOSGeometry *ls, bool exterior_ring);
 
+        void process_ring(const CoordinateRange &ring, bool exterior_ring);
+
         void process_rectangular_ring(const Box & box, bool exterior_ring);
 
         void add_ring_areas(size_t i0, size_t j0, const Matrix<float> &areas, bool exterior_ring);
@@ -52,6 +59,7 @@ namespace exactextract {
     };
 
     Raster<float> raster_cell_intersection(const Grid<bounded_extent> & raster_grid, GEOSContextHandle_t context, const GEOSGeometry* g);
+    Raster<float> raster_cell_intersection(const Grid<bounded_extent> & raster_grid, const FlatGeometry & g);
     Raster<float> raster_cell_intersection(const Grid<bounded_extent> & raster_grid, const Box & box);
     Box processing_region(const Box & raster_extent, const std::vector<Box> & component_boxes);
 }
@@ -11,111 +11,380 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include "feature_spill_store.h"
 #include "raster_sequential_processor.h"
+#include "shared_edge_coverage.h"
 
 #include <map>
 #include <memory>
 #include <set>
+#include <stdexcept>
+#include <unordered_set>
 
 namespace exactextract {
 
-    void RasterSequentialProcessor::read_features() {
-        while (m_shp.next()) {
-            Feature feature = std::make_pair(
-                    m_shp.feature_field(m_shp.id_field()),
-                    geos_ptr(m_geos_context, m_shp.feature_geometry(m_geos_context)));
-            m_features.push_back(std::move(feature));
+    // Results are accumulated and written by feature ID, so features that
+    // share an ID would be merged into a single row.
+    static void check_unique_id(std::unordered_set<FeatureId> & seen, const FeatureId & name) {
+        if (!seen.insert(name).second) {
+            throw std::runtime_error("Feature ID " + name.to_string() + " is not unique. "
+                                     "The raster-sequential strategy requires unique feature IDs; use the feature-sequential strategy instead.");
         }
     }
 
-    void RasterSequentialProcessor::populate_index() {
-        for (const Feature& f : m_features) {
-            // TODO compute envelope of dataset, and crop raster by that extent before processing?
-            GEOSSTRtree_insert_r(m_geos_context, m_feature_tree.get(), f.second.get(), (void *) &f);
+    void RasterSequentialProcessor::add_layer(GDALDatasetWrapper & ds, OutputWriter & out) {
+        m_registries.push_back(std::make_unique<StatsRegistry>());
+        StatsRegistry & reg = *m_registries.back();
+
+        for (const auto& op : m_operations) {
+            reg.add_operation(op);
+        }
+        out.set_registry(&reg);
+
+        Layer layer;
+        layer.shp = &ds;
+        layer.output = &out;
+        layer.reg = &reg;
+        m_layers.push_back(std::move(layer));
+    }
+
+    void RasterSequentialProcessor::read_features(Layer & layer) {
+        // When features can be read back by FID, only their envelopes are
+        // needed to plan the work; geometries are decoded when the first
+        // subgrid that a feature intersects is processed.
+        layer.lazy_geometry = m_lazy_geometry && layer.shp->supports_random_read();
+
+        std::unordered_set<FeatureId> seen;
+        while (layer.shp->next()) {
+            Feature feature;
+            feature.name = layer.shp->feature_id();
+            check_unique_id(seen, feature.name);
+
+            if (layer.lazy_geometry) {
+                feature.fid = layer.shp->feature_fid();
+                feature.box = layer.shp->feature_envelope();
+            } else {
+                layer.shp->feature_geometry(feature.geometry);
+                feature.box = feature.geometry.box();
+                feature.loaded = true;
+            }
+
+            layer.features.push_back(std::move(feature));
+        }
+    }
+
+    void RasterSequentialProcessor::populate_index(Layer & layer) {
+        std::vector<Box> boxes;
+        boxes.reserve(layer.features.size());
+        for (const Feature& f : layer.features) {
+            // Null geometries have an empty box, which is not indexed.
+            boxes.push_back(f.box);
+        }
+
+        layer.tree = PackedRTree(boxes);
+    }
+
+    void RasterSequentialProcessor::load_geometry(Layer & layer, Feature & f) {
+        // A geometry that decodes as empty is not read again.
+        if (f.loaded) {
+            return;
+        }
+
+        if (!layer.shp->seek(f.fid)) {
+            throw std::runtime_error("Failed to read feature " + f.name.to_string() + ".");
+        }
+
+        layer.shp->feature_geometry(f.geometry);
+        f.loaded = true;
+    }
+
+    // Subgrids produced by subdivide() are ordered by row, from top to bottom,
+    // and then by column, from left to right. This allows the subgrids that
+    // intersect a box to be found by bisection.
+    static void intersecting_subgrids(const std::vector<Grid<bounded_extent>> & subgrids, size_t cols, const Box & box, std::vector<size_t> & out) {
+        out.clear();
+
+        // Return the first index in [0, n) for which pred is true, given that
+        // pred is false for all indices before it and true for all after.
+        auto first = [](size_t n, auto&& pred) {
+            size_t lo = 0;
+            size_t hi = n;
+            while (lo < hi) {
+                size_t mid = lo + (hi - lo) / 2;
+                if (pred(mid)) {
+                    hi = mid;
+                } else {
+                    lo = mid + 1;
+                }
+            }
+            return lo;
+        };
+
+        size_t rows = subgrids.size() / cols;
+
+        size_t col0 = first(cols, [&](size_t j) { return subgrids[j].xmax() >= box.xmin; });
+        size_t col1 = first(cols, [&](size_t j) { return subgrids[j].xmin() > box.xmax; });
+        size_t row0 = first(rows, [&](size_t i) { return subgrids[i*cols].ymin() <= box.ymax; });
+        size_t row1 = first(rows, [&](size_t i) { return subgrids[i*cols].ymax() < box.ymin; });
+
+        for (size_t i = row0; i < row1; i++) {
+            for (size_t j = col0; j < col1; j++) {
+                out.push_back(i*cols + j);
+            }
         }
     }
 
     void RasterSequentialProcessor::process() {
-        read_features();
-        populate_index();
+        // The layer passed to the constructor is processed along with any
+        // added by add_layer().
+        Layer primary;
+        primary.shp = &m_shp;
+        primary.output = &m_output;
+        primary.reg = &m_reg;
+        primary.cells = m_cell_writer;
+        primary.coverage_raster = m_coverage_raster;
+        m_layers.insert(m_layers.begin(), std::move(primary));
 
-        for (const auto& op : m_operations) {
-            m_output.add_operation(op);
+        for (auto& layer : m_layers) {
+            for (const auto& op : m_operations) {
+                layer.output->add_operation(op);
+            }
         }
 
         auto grid = common_grid(m_operations.begin(), m_operations.end());
+        auto subgrids = subdivide(grid, m_max_cells_in_memory);
 
-        for (const auto &subgrid : subdivide(grid, m_max_cells_in_memory)) {
-            std::vector<const Feature *> hits;
+        if (!m_spill_dir.empty()) {
+            if (m_layers.size() > 1) {
+                throw std::runtime_error("Spilling features to disk is only supported for a single layer.");
+            }
+            process_spilled(subgrids);
+            return;
+        }
 
-            auto query_rect = geos_make_box_polygon(m_geos_context, subgrid.extent());
+        std::vector<size_t> indices;
 
-            GEOSSTRtree_query_r(m_geos_context, m_feature_tree.get(), query_rect.get(), [](void *hit, void *userdata) {
-                auto feature = static_cast<const Feature *>(hit);
-                auto vec = static_cast<std::vector<const Feature *> *>(userdata);
+        for (auto& layer : m_layers) {
+            read_features(layer);
+            populate_index(layer);
 
-                vec->push_back(feature);
-            }, &hits);
+            // Count the subgrids intersected by each feature so that its results
+            // can be written as soon as the last of them has been processed.
+            for (const auto &subgrid : subgrids) {
+                layer.tree.query(subgrid.extent(), indices);
+                for (size_t i : indices) {
+                    layer.remaining_subgrids[layer.features[i].name]++;
+                }
+            }
 
-            std::map<RasterSource*, std::unique_ptr<AbstractRaster<double>>> raster_values;
+            // Features that intersect no subgrid are written immediately.
+            for (const auto& f : layer.features) {
+                if (layer.remaining_subgrids.find(f.name) == layer.remaining_subgrids.end()) {
+                    layer.output->write(f.name);
+                }
+            }
+        }
 
-            for (const auto &f : hits) {
-                std::unique_ptr<Raster<float>> coverage;
-                std::set<std::pair<RasterSource*, RasterSource*>> processed;
-
-                for (const auto &op : m_operations) {
-                    // Avoid processing same values/weights for different stats
-                    auto key = std::make_pair(op.weights, op.values);
-                    if (processed.find(key) != processed.end()) {
-                        continue;
-                    } else {
-                        processed.insert(key);
-                    }
+        std::vector<const Feature *> hits;
 
-                    if (!op.values->grid().extent().contains(subgrid.extent())) {
-                        continue;
-                    }
+        for (const auto &subgrid : subgrids) {
+            // Raster values are read once for each subgrid and shared by all layers.
+            RasterValues raster_values;
 
-                    if (op.weighted() && !op.weights->grid().extent().contains(subgrid.extent())) {
-                        continue;
-                    }
+            for (auto& layer : m_layers) {
+                layer.tree.query(subgrid.extent(), indices);
 
-                    // Lazy-initialize coverage
-                    if (coverage == nullptr) {
-                        coverage = std::make_unique<Raster<float>>(
-                                raster_cell_intersection(subgrid, m_geos_context, f->second.get()));
-                    }
+                hits.clear();
+                for (size_t i : indices) {
+                    load_geometry(layer, layer.features[i]);
+                    hits.push_back(&layer.features[i]);
+                }
 
-                    // FIXME need to ensure that no values are read from a raster that have already been read.
-                    // This may be possible when reading box is expanded slightly from floating-point roundoff problems.
-                    auto values = raster_values[op.values].get();
-                    if (values == nullptr) {
-                        raster_values[op.values] = op.values->read_box(subgrid.extent().intersection(op.values->grid().extent()));
-                        values = raster_values[op.values].get();
-                    }
+                process_subgrid(subgrid, layer, hits, raster_values);
 
-                    if (op.weighted()) {
-                        auto weights = raster_values[op.weights].get();
-                        if (weights == nullptr) {
-                            raster_values[op.weights] = op.weights->read_box(subgrid.extent().intersection(op.weights->grid().extent()));
-                            weights = raster_values[op.weights].get();
+                if (layer.lazy_geometry) {
+                    // Release the geometries of features that have been written.
+                    for (size_t i : indices) {
+                        if (layer.remaining_subgrids.find(layer.features[i].name) == layer.remaining_subgrids.end()) {
+                            layer.features[i].geometry = FlatGeometry();
                         }
+                    }
+                }
+            }
+
+            progress(subgrid.extent());
+        }
+    }
 
-                        m_reg.stats(f->first, op).process(*coverage, *values, *weights);
-                    } else {
-                        m_reg.stats(f->first, op).process(*coverage, *values);
+    void RasterSequentialProcessor::process_spilled(const std::vector<Grid<bounded_extent>> & subgrids) {
+        Layer & layer = m_layers.front();
+        FeatureSpillStore store(m_spill_dir, subgrids.size());
+
+        size_t cols = 1;
+        while (cols < subgrids.size() && subgrids[cols].ymax() == subgrids[0].ymax()) {
+            cols++;
+        }
+
+        {
+            FlatGeometry geom;
+            std::vector<size_t> buckets;
+            std::unordered_set<FeatureId> seen;
+
+            while (m_shp.next()) {
+                FeatureId name = m_shp.feature_id();
+                check_unique_id(seen, name);
+                m_shp.feature_geometry(geom);
+
+                buckets.clear();
+                if (!geom.empty()) {
+                    intersecting_subgrids(subgrids, cols, geom.box(), buckets);
+                }
+
+                if (buckets.empty()) {
+                    // Nothing to compute, so the feature can be written now.
+                    m_output.write(name);
+                    continue;
+                }
+
+                layer.remaining_subgrids[name] += buckets.size();
+                for (size_t bucket : buckets) {
+                    store.add(bucket, name, geom);
+                }
+            }
+        }
+
+        for (size_t i = 0; i < subgrids.size(); i++) {
+            std::vector<Feature> features;
+            features.reserve(store.size(i));
+
+            store.read(i, [&features](const FeatureId & name, const FlatGeometry & geom) {
+                Feature f;
+                f.name = name;
+                f.geometry = geom;
+                f.loaded = true;
+                features.push_back(std::move(f));
+            });
+
+            std::vector<const Feature*> hits;
+            hits.reserve(features.size());
+            for (const auto& f : features) {
+                hits.push_back(&f);
+            }
+
+            RasterValues raster_values;
+            process_subgrid(subgrids[i], layer, hits, raster_values);
+            progress(subgrids[i].extent());
+        }
+    }
+
+    void RasterSequentialProcessor::process_subgrid(const Grid<bounded_extent> & subgrid,
+                                                    Layer & layer,
+                                                    const std::vector<const Feature*> & hits,
+                                                    RasterValues & raster_values) {
+        auto grid = common_grid(m_operations.begin(), m_operations.end());
+
+        std::vector<Raster<float>> shared_coverage;
+        if (m_shared_edges) {
+            std::vector<const FlatGeometry*> geoms;
+            geoms.reserve(hits.size());
+            for (const auto &f : hits) {
+                geoms.push_back(&f->geometry);
+            }
+            shared_coverage = shared_edge_coverage(subgrid, geoms);
+        }
+
+        auto compute_coverage = [&](size_t i) {
+            if (m_shared_edges) {
+                return std::make_unique<Raster<float>>(std::move(shared_coverage[i]));
+            }
+            return std::make_unique<Raster<float>>(raster_cell_intersection(subgrid, hits[i]->geometry));
+        };
+
+        if (layer.coverage_raster != nullptr) {
+            layer.coverage_raster->begin_window(subgrid);
+        }
+
+        for (size_t i = 0; i < hits.size(); i++) {
+            const Feature* f = hits[i];
+
+            // An empty geometry may still have a non-empty envelope when
+            // envelopes are read without decoding geometries.
+            if (f->geometry.empty()) {
+                continue;
+            }
+
+            std::unique_ptr<Raster<float>> coverage;
+            std::set<std::pair<RasterSource*, RasterSource*>> processed;
+
+            for (const auto &op : m_operations) {
+                // Avoid processing same values/weights for different stats
+                auto key = std::make_pair(op.weights, op.values);
+                if (processed.find(key) != processed.end()) {
+                    continue;
+                } else {
+                    processed.insert(key);
+                }
+
+                if (!op.values->grid().extent().contains(subgrid.extent())) {
+                    continue;
+                }
+
+                if (op.weighted() && !op.weights->grid().extent().contains(subgrid.extent())) {
+                    continue;
+                }
+
+                // Lazy-initialize coverage
+                if (coverage == nullptr) {
+                    coverage = compute_coverage(i);
+                }
+
+                // FIXME need to ensure that no values are read from a raster that have already been read.
+                // This may be possible when reading box is expanded slightly from floating-point roundoff problems.
+                auto values = raster_values[op.values].get();
+                if (values == nullptr) {
+                    raster_values[op.values] = op.values->read_box(subgrid.extent().intersection(op.values->grid().extent()));
+                    values = raster_values[op.values].get();
+                }
+
+                AbstractRaster<double>* weights = nullptr;
+                if (op.weighted()) {
+                    weights = raster_values[op.weights].get();
+                    if (weights == nullptr) {
+                        raster_values[op.weights] = op.weights->read_box(subgrid.extent().intersection(op.weights->grid().extent()));
+                        weights = raster_values[op.weights].get();
                     }
 
-                    progress();
+                    layer.reg->stats(f->name, op).process(*coverage, *values, *weights);
+                } else {
+                    layer.reg->stats(f->name, op).process(*coverage, *values);
                 }
+
+                if (layer.cells != nullptr) {
+                    layer.cells->write(f->name, op, grid, *coverage, *values, weights);
+                }
+
+                progress();
             }
 
-            progress(subgrid.extent());
+            if (layer.coverage_raster != nullptr) {
+                if (coverage == nullptr) {
+                    coverage = compute_coverage(i);
+                }
+                layer.coverage_raster->add(f->name, *coverage);
+            }
         }
 
-        for (const auto& f : m_features) {
-            m_output.write(f.first);
-            m_reg.flush_feature(f.first);
+        if (layer.coverage_raster != nullptr) {
+            layer.coverage_raster->end_window();
+        }
+
+        for (const auto &f : hits) {
+            auto it = layer.remaining_subgrids.find(f->name);
+            if (--it->second == 0) {
+                layer.remaining_subgrids.erase(it);
+                layer.output->write(f->name);
+                layer.reg->flush_feature(f->name);
+            }
         }
     }
 
@@ -16,8 +16,14 @@
 #ifndef EXACTEXTRACT_RASTER_SEQUENTIAL_PROCESSOR_H
 #define EXACTEXTRACT_RASTER_SEQUENTIAL_PROCESSOR_H
 
+#include <map>
+#include <unordered_map>
+#include <vector>
 
-#include "geos_utils.h"
+#include "coverage_raster_writer.h"
+#include "feature_id.h"
+#include "flat_geometry.h"
+#include "packed_rtree.h"
 #include "processor.h"
 
 namespace exactextract {
@@ -26,16 +32,110 @@ namespace exactextract {
     public:
         using Processor::Processor;
 
-        void read_features();
-        void populate_index();
+        /**
+         * Process the features of an additional layer, writing their results
+         * to `out`. Raster values read for each subgrid are shared by the
+         * features of all layers.
+         */
+        void add_layer(GDALDatasetWrapper & ds, OutputWriter & out);
 
+        /**
+         * Process the features intersecting each subgrid in turn. Results for
+         * a feature are written, and its statistics released, as soon as the
+         * last subgrid intersecting its envelope has been processed, so
+         * features are written in the order in which they complete rather
+         * than the order in which they were read. Because results are
+         * accumulated by feature ID, an exception is thrown if two features
+         * of a layer have the same ID.
+         */
         void process() override;
 
+        /**
+         * Instead of holding all features in memory, write them to temporary
+         * files in `dir`, partitioned by the subgrid(s) they intersect, and
+         * read back the features of one subgrid at a time.
+         */
+        void set_spill_dir(const std::string & dir) {
+            m_spill_dir = dir;
+        }
+
+        /**
+         * Compute the coverage of all features intersecting a subgrid together,
+         * processing each edge shared by two features only once. This benefits
+         * polygon coverages, such as administrative boundaries, in which
+         * neighbouring polygons have identical vertices along their common
+         * boundaries.
+         */
+        void set_shared_edges(bool val) {
+            m_shared_edges = val;
+        }
+
+        /**
+         * For layers that support random reads, keep only the envelopes of
+         * features in memory, reading each geometry again by FID when the
+         * first subgrid that it intersects is processed. This reduces memory
+         * use for large layers at the cost of reading each geometry twice.
+         */
+        void set_lazy_geometry(bool val) {
+            m_lazy_geometry = val;
+        }
+
+        /**
+         * Also combine the coverage fractions of the features of the primary
+         * layer into a raster, written one subgrid at a time by `writer`.
+         */
+        void set_coverage_raster_writer(CoverageRasterWriter* writer) {
+            m_coverage_raster = writer;
+        }
+
     private:
-        using Feature=std::pair<std::string, geom_ptr_r>;
+        struct Feature {
+            FeatureId name;
+            GIntBig fid = 0;
+            Box box = Box::make_empty();
+            FlatGeometry geometry;
+            bool loaded = false;
+        };
+
+        struct Layer {
+            GDALDatasetWrapper* shp = nullptr;
+            OutputWriter* output = nullptr;
+            StatsRegistry* reg = nullptr;
+            std::vector<Feature> features;
+            PackedRTree tree;
+            std::unordered_map<FeatureId, size_t> remaining_subgrids;
+            CellWriter* cells = nullptr;
+            CoverageRasterWriter* coverage_raster = nullptr;
+            bool lazy_geometry = false;
+        };
+
+        using RasterValues = std::map<RasterSource*, std::unique_ptr<AbstractRaster<double>>>;
+
+        /**
+         * Read the IDs and envelopes of all features. Geometries are also read
+         * unless lazy geometry is enabled and the layer supports random reads,
+         * in which case each is read when first needed and released once the
+         * feature has been written.
+         */
+        void read_features(Layer & layer);
+
+        void populate_index(Layer & layer);
+
+        void load_geometry(Layer & layer, Feature & f);
+
+        void process_spilled(const std::vector<Grid<bounded_extent>> & subgrids);
+
+        void process_subgrid(const Grid<bounded_extent> & subgrid,
+                             Layer & layer,
+                             const std::vector<const Feature*> & hits,
+                             RasterValues & raster_values);
 
-        std::vector<Feature> m_features;
-        tree_ptr_r m_feature_tree{geos_ptr(m_geos_context, GEOSSTRtree_create_r(m_geos_context, 10))};
+        std::string m_spill_dir;
+        CoverageRasterWriter* m_coverage_raster = nullptr;
+        bool m_shared_edges = false;
+        bool m_lazy_geometry = false;
+        std::vector<Layer> m_layers;
+        std::vector<std::unique_ptr<StatsRegistry>> m_registries;
     };
 
 }
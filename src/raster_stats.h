@@ -17,6 +17,7 @@
 #include <algorithm>
 #include <iostream>
 #include <limits>
+#include <memory>
 #include <unordered_map>
 
 #include "raster_cell_intersection.h"
@@ -43,7 +44,7 @@ namespace exactextract {
                 m_sum_ci{0},
                 m_sum_xici{0},
                 m_sum_xiciwi{0},
-                m_store_values{store_values} {}
+                m_freq{store_values ? std::make_unique<std::unordered_map<T, float>>() : nullptr} {}
 
         void process(const Raster<float> & intersection_percentages, const AbstractRaster<T> & rast) {
             RasterView<T> rv{rast, intersection_percentages.grid()};
@@ -131,8 +132,8 @@ namespace exactextract {
                 return nonstd::nullopt;
             }
 
-            return std::max_element(m_freq.cbegin(),
-                                    m_freq.cend(),
+            return std::max_element(m_freq->cbegin(),
+                                    m_freq->cend(),
                                     [](const auto &a, const auto &b) {
                                         return a.second < b.second || (a.second == b.second && a.first < b.first);
                                     })->first;
@@ -165,7 +166,7 @@ namespace exactextract {
          * are taken into account but weights are not.
          */
         nonstd::optional<T> quantile(double q) const {
-            if (m_sum_ci == 0) {
+            if (m_sum_ci == 0 || !m_freq) {
                 return nonstd::nullopt;
             }
 
@@ -174,7 +175,7 @@ namespace exactextract {
             if (!m_quantiles) {
                 m_quantiles = std::make_unique<WeightedQuantiles>();
 
-                for (const auto& entry : m_freq) {
+                for (const auto& entry : *m_freq) {
                     m_quantiles->process(entry.first, entry.second);
                 }
             }
@@ -266,8 +267,8 @@ namespace exactextract {
                 return nonstd::nullopt;
             }
 
-            return std::min_element(m_freq.cbegin(),
-                                    m_freq.cend(),
+            return std::min_element(m_freq->cbegin(),
+                                    m_freq->cend(),
                                     [](const auto &a, const auto &b) {
                                         return a.second < b.second || (a.second == b.second && a.first < b.first);
                                     })->first;
@@ -278,11 +279,39 @@ namespace exactextract {
          * or partially covered by the polygon.
          */
         size_t variety() const {
-            return m_freq.size();
+            return m_freq ? m_freq->size() : 0;
         }
 
         bool stores_values() const {
-            return m_store_values;
+            return m_freq != nullptr;
+        }
+
+        /**
+         * Update these stats with the values processed by `other`, as if
+         * they had been computed over the union of the two polygons. The
+         * polygons are assumed not to overlap.
+         */
+        void combine(const RasterStats<T> & other) {
+            m_sum_ci += other.m_sum_ci;
+            m_sum_ciwi += other.m_sum_ciwi;
+            m_sum_xici += other.m_sum_xici;
+            m_sum_xiciwi += other.m_sum_xiciwi;
+            m_variance.combine(other.m_variance);
+
+            if (other.m_min < m_min) {
+                m_min = other.m_min;
+            }
+
+            if (other.m_max > m_max) {
+                m_max = other.m_max;
+            }
+
+            if (m_freq && other.m_freq) {
+                for (const auto& entry : *other.m_freq) {
+                    (*m_freq)[entry.first] += entry.second;
+                }
+                m_quantiles.reset();
+            }
         }
 
     private:
@@ -300,9 +329,8 @@ namespace exactextract {
 
         mutable std::unique_ptr<WeightedQuantiles> m_quantiles;
 
-        std::unordered_map<T, float> m_freq;
-
-        bool m_store_values;
+        // Coverage of each distinct value, allocated only if values are stored
+        std::unique_ptr<std::unordered_map<T, float>> m_freq;
 
         void process_value(const T& val, float coverage, double weight) {
             m_sum_ci += static_cast<double>(coverage);
@@ -323,8 +351,8 @@ namespace exactextract {
             }
 
             // TODO should weights factor in here?
-            if (m_store_values) {
-                m_freq[val] += coverage;
+            if (m_freq) {
+                (*m_freq)[val] += coverage;
                 m_quantiles.reset();
             }
         }
@@ -0,0 +1,179 @@
+// Copyright (c) 2020 ISciences, LLC.
+// All rights reserved.
+//
+// This software is licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License. You may
+// obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0.
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "resampled_raster_source.h"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+namespace exactextract {
+
+    ResampleMethod parse_resample_method(const std::string & name) {
+        if (name == "nearest") {
+            return ResampleMethod::NEAREST;
+        } else if (name == "average") {
+            return ResampleMethod::AVERAGE;
+        } else {
+            throw std::runtime_error("Unknown resampling method: " + name);
+        }
+    }
+
+    ResampledRasterSource::ResampledRasterSource(RasterSource & source,
+                                                 const Grid<bounded_extent> & grid,
+                                                 ResampleMethod method,
+                                                 size_t block_size,
+                                                 size_t max_cached_blocks) :
+        m_source{source},
+        m_grid{grid},
+        m_method{method},
+        m_block_size{block_size},
+        m_max_cached_blocks{std::max(max_cached_blocks, static_cast<size_t>(1))},
+        m_last_block{nullptr},
+        m_last_block_key{0},
+        m_access_count{0},
+        m_blocks_read{0}
+    {
+        if (m_block_size == 0) {
+            throw std::invalid_argument("Block size must be positive.");
+        }
+
+        set_name(source.name());
+    }
+
+    std::unique_ptr<AbstractRaster<double>> ResampledRasterSource::read_box(const Box &box) {
+        auto cropped_grid = m_grid.shrink_to_fit(box);
+        auto vals = std::make_unique<Raster<double>>(cropped_grid);
+
+        const auto& src_grid = m_source.grid();
+        const Box& src_extent = src_grid.extent();
+
+        for (size_t i = 0; i < cropped_grid.rows(); i++) {
+            for (size_t j = 0; j < cropped_grid.cols(); j++) {
+                double result = std::numeric_limits<double>::quiet_NaN();
+
+                if (m_method == ResampleMethod::NEAREST) {
+                    Coordinate center{cropped_grid.x_for_col(j), cropped_grid.y_for_row(i)};
+
+                    double val;
+                    if (src_extent.contains(center) &&
+                        source_value(src_grid.get_row(center.y), src_grid.get_column(center.x), val)) {
+                        result = val;
+                    }
+                } else {
+                    Box cell = grid_cell(cropped_grid, i, j);
+
+                    if (cell.intersects(src_extent)) {
+                        Box isect = cell.intersection(src_extent);
+
+                        size_t row0 = src_grid.get_row(isect.ymax);
+                        size_t row1 = src_grid.get_row(isect.ymin);
+                        size_t col0 = src_grid.get_column(isect.xmin);
+                        size_t col1 = src_grid.get_column(isect.xmax);
+
+                        double sum = 0;
+                        double sum_w = 0;
+
+                        for (size_t r = row0; r <= row1; r++) {
+                            for (size_t c = col0; c <= col1; c++) {
+                                Box src_cell = grid_cell(src_grid, r, c);
+                                if (!src_cell.intersects(isect)) {
+                                    continue;
+                                }
+
+                                double w = src_cell.intersection(isect).area();
+
+                                double val;
+                                if (w > 0 && source_value(r, c, val)) {
+                                    sum += val * w;
+                                    sum_w += w;
+                                }
+                            }
+                        }
+
+                        if (sum_w > 0) {
+                            result = sum / sum_w;
+                        }
+                    }
+                }
+
+                (*vals)(i, j) = result;
+            }
+        }
+
+        return vals;
+    }
+
+    bool ResampledRasterSource::source_value(size_t row, size_t col, double & val) {
+        CachedBlock& b = block(row, col);
+
+        return b.values->get(row - b.row0, col - b.col0, val);
+    }
+
+    ResampledRasterSource::CachedBlock& ResampledRasterSource::block(size_t row, size_t col) {
+        const auto& src_grid = m_source.grid();
+
+        size_t block_row = row / m_block_size;
+        size_t block_col = col / m_block_size;
+        size_t blocks_per_row = (src_grid.cols() + m_block_size - 1) / m_block_size;
+        size_t key = block_row * blocks_per_row + block_col;
+
+        m_access_count++;
+
+        if (m_last_block != nullptr && m_last_block_key == key) {
+            m_last_block->last_used = m_access_count;
+            return *m_last_block;
+        }
+
+        auto it = m_blocks.find(key);
+        if (it == m_blocks.end()) {
+            if (m_blocks.size() >= m_max_cached_blocks) {
+                auto lru = std::min_element(m_blocks.begin(), m_blocks.end(), [](const auto& a, const auto& b) {
+                    return a.second.last_used < b.second.last_used;
+                });
+                if (&(lru->second) == m_last_block) {
+                    m_last_block = nullptr;
+                }
+                m_blocks.erase(lru);
+            }
+
+            size_t row_begin = block_row * m_block_size;
+            size_t row_end = std::min(row_begin + m_block_size, src_grid.rows());
+            size_t col_begin = block_col * m_block_size;
+            size_t col_end = std::min(col_begin + m_block_size, src_grid.cols());
+
+            Box block_box{
+                src_grid.xmin() + static_cast<double>(col_begin) * src_grid.dx(),
+                row_end == src_grid.rows() ? src_grid.ymin() : src_grid.ymax() - static_cast<double>(row_end) * src_grid.dy(),
+                col_end == src_grid.cols() ? src_grid.xmax() : src_grid.xmin() + static_cast<double>(col_end) * src_grid.dx(),
+                src_grid.ymax() - static_cast<double>(row_begin) * src_grid.dy()
+            };
+
+            CachedBlock b;
+            b.values = m_source.read_box(block_box);
+            b.row0 = b.values->grid().row_offset(src_grid);
+            b.col0 = b.values->grid().col_offset(src_grid);
+            m_blocks_read++;
+
+            it = m_blocks.emplace(key, std::move(b)).first;
+        }
+
+        it->second.last_used = m_access_count;
+
+        m_last_block = &(it->second);
+        m_last_block_key = key;
+
+        return it->second;
+    }
+
+}
@@ -0,0 +1,91 @@
+// Copyright (c) 2020 ISciences, LLC.
+// All rights reserved.
+//
+// This software is licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License. You may
+// obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0.
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef EXACTEXTRACT_RESAMPLED_RASTER_SOURCE_H
+#define EXACTEXTRACT_RESAMPLED_RASTER_SOURCE_H
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "grid.h"
+#include "raster.h"
+#include "raster_source.h"
+
+namespace exactextract {
+
+    enum class ResampleMethod {
+        NEAREST, // value of the source cell containing the center of the target cell
+        AVERAGE  // mean of source cells overlapping the target cell, weighted by area of overlap
+    };
+
+    ResampleMethod parse_resample_method(const std::string & name);
+
+    /**
+     * A RasterSource that presents the values of another RasterSource on a
+     * different grid, which need not be compatible with the grid of the source.
+     * Values are resampled lazily for each window requested by read_box. Blocks
+     * of the source raster are read as needed and retained in a cache of bounded
+     * size, so that windows sharing source cells do not require the source to
+     * be read more than once.
+     *
+     * Target cells for which no defined source value is available are assigned
+     * a value of NaN.
+     */
+    class ResampledRasterSource : public RasterSource {
+    public:
+        ResampledRasterSource(RasterSource & source,
+                              const Grid<bounded_extent> & grid,
+                              ResampleMethod method,
+                              size_t block_size = 256,
+                              size_t max_cached_blocks = 64);
+
+        const Grid<bounded_extent> &grid() const override {
+            return m_grid;
+        }
+
+        std::unique_ptr<AbstractRaster<double>> read_box(const Box &box) override;
+
+        /** Return the number of blocks that have been read from the source. */
+        size_t blocks_read() const {
+            return m_blocks_read;
+        }
+
+    private:
+        struct CachedBlock {
+            std::unique_ptr<AbstractRaster<double>> values;
+            size_t row0;
+            size_t col0;
+            size_t last_used;
+        };
+
+        bool source_value(size_t row, size_t col, double & val);
+
+        CachedBlock& block(size_t row, size_t col);
+
+        RasterSource& m_source;
+        Grid<bounded_extent> m_grid;
+        ResampleMethod m_method;
+        size_t m_block_size;
+        size_t m_max_cached_blocks;
+
+        std::unordered_map<size_t, CachedBlock> m_blocks;
+        CachedBlock* m_last_block;
+        size_t m_last_block_key;
+        size_t m_access_count;
+        size_t m_blocks_read;
+    };
+
+}
+
+#endif //EXACTEXTRACT_RESAMPLED_RASTER_SOURCE_H
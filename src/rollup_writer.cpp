@@ -0,0 +1,65 @@
+// Copyright (c) 2021 ISciences, LLC.
+// All rights reserved.
+//
+// This software is licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License. You may
+// obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0.
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "rollup_writer.h"
+
+#include <utility>
+
+namespace exactextract {
+
+    RollupWriter::RollupWriter(OutputWriter & child, OutputWriter & parent, std::unordered_map<FeatureId, FeatureId> parents) :
+        m_child{child},
+        m_parent{parent},
+        m_parents{std::move(parents)},
+        m_child_reg{nullptr}
+    {
+        m_parent.set_registry(&m_parent_reg);
+    }
+
+    void RollupWriter::add_operation(const Operation & op) {
+        m_child.add_operation(op);
+        m_parent.add_operation(op);
+        m_parent_reg.add_operation(op);
+
+        m_ops.push_back(&op);
+    }
+
+    void RollupWriter::set_registry(const StatsRegistry* reg) {
+        m_child_reg = reg;
+        m_child.set_registry(reg);
+    }
+
+    void RollupWriter::write(const FeatureId & fid) {
+        auto it = m_parents.find(fid);
+        if (it != m_parents.end()) {
+            if (m_seen_parents.insert(it->second).second) {
+                m_parent_order.push_back(it->second);
+            }
+
+            m_parent_reg.combine(it->second, *m_child_reg, fid);
+        }
+
+        m_child.write(fid);
+    }
+
+    void RollupWriter::finish() {
+        for (const auto& parent : m_parent_order) {
+            m_parent.write(parent);
+            m_parent_reg.flush_feature(parent);
+        }
+
+        m_child.finish();
+        m_parent.finish();
+    }
+
+}
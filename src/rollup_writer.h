@@ -0,0 +1,66 @@
+// Copyright (c) 2021 ISciences, LLC.
+// All rights reserved.
+//
+// This software is licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License. You may
+// obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0.
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef EXACTEXTRACT_ROLLUP_WRITER_H
+#define EXACTEXTRACT_ROLLUP_WRITER_H
+
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "output_writer.h"
+#include "stats_registry.h"
+
+namespace exactextract {
+
+    /**
+     * An OutputWriter that passes results for each feature to another writer,
+     * and also accumulates them into the results for the feature's parent, so
+     * that stats for a layer of nested zones (e.g., administrative units) can
+     * be produced without computing coverage for the coarser polygons.
+     *
+     * Parent results are written to a separate writer by finish(), in the
+     * order in which the parents were first encountered. Writers may be
+     * chained to produce several levels of roll-up from the finest level.
+     */
+    class RollupWriter : public OutputWriter {
+    public:
+        /**
+         * @param child   writer for the results of each feature
+         * @param parent  writer for the combined results of each parent
+         * @param parents map of feature ID to parent ID. Features without a
+         *                parent are not included in any parent's results.
+         */
+        RollupWriter(OutputWriter & child, OutputWriter & parent, std::unordered_map<FeatureId, FeatureId> parents);
+
+        void add_operation(const Operation & op) override;
+
+        void set_registry(const StatsRegistry* reg) override;
+
+        void write(const FeatureId & fid) override;
+
+        void finish() override;
+
+    private:
+        OutputWriter& m_child;
+        OutputWriter& m_parent;
+        std::unordered_map<FeatureId, FeatureId> m_parents;
+        std::vector<FeatureId> m_parent_order;
+        std::unordered_set<FeatureId> m_seen_parents;
+        const StatsRegistry* m_child_reg;
+        StatsRegistry m_parent_reg;
+    };
+
+}
+
+#endif //EXACTEXTRACT_ROLLUP_WRITER_H
@@ -0,0 +1,314 @@
+// Copyright (c) 2021 ISciences, LLC.
+// All rights reserved.
+//
+// This software is licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License. You may
+// obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0.
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "shared_edge_coverage.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+
+#include "area.h"
+
+namespace exactextract {
+
+    namespace {
+
+        struct EdgeKey {
+            Coordinate a;
+            Coordinate b;
+
+            bool operator==(const EdgeKey & other) const {
+                return a == other.a && b == other.b;
+            }
+        };
+
+        struct EdgeKeyHash {
+            size_t operator()(const EdgeKey & k) const {
+                std::hash<double> h;
+                size_t seed = h(k.a.x);
+                for (double v : {k.a.y, k.b.x, k.b.y}) {
+                    seed ^= h(v) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+                }
+                return seed;
+            }
+        };
+
+        struct Owner {
+            size_t polygon;
+            double sign;
+        };
+
+        // An edge in a canonical direction, with the polygons on either side.
+        // Edges shared by more than two rings are recorded more than once.
+        struct Edge {
+            Coordinate a;
+            Coordinate b;
+            Owner owners[2];
+            size_t num_owners;
+        };
+
+        // Signed area accumulated in the cells of a polygon's envelope. Each
+        // row has an extra column to receive contributions from edges at its
+        // right-hand side.
+        struct Accumulator {
+            Grid<bounded_extent> grid;
+            size_t row0;
+            size_t col0;
+            std::vector<double> cells;
+
+            void add(size_t row, size_t col, double value) {
+                if (row < row0 || row >= row0 + grid.rows()) {
+                    return;
+                }
+                size_t j = col < col0 ? 0 : std::min(col - col0, grid.cols());
+                cells[(row - row0) * (grid.cols() + 1) + j] += value;
+            }
+        };
+
+    }
+
+    // Accumulate the signed area to the right of the segment (x0, y0)-(x1, y1),
+    // given in units of cells with y increasing downward, into the cells of
+    // each row that the segment crosses. This follows the approach of the
+    // font-rs rasterizer.
+    template<typename F>
+    static void accumulate_segment(double x0, double y0, double x1, double y1, size_t rows, F && add) {
+        if (y0 == y1) {
+            return;
+        }
+
+        double dir = 1;
+        if (y0 > y1) {
+            std::swap(x0, x1);
+            std::swap(y0, y1);
+            dir = -1;
+        }
+
+        if (y1 <= 0 || y0 >= static_cast<double>(rows)) {
+            return;
+        }
+
+        double dxdy = (x1 - x0) / (y1 - y0);
+        double x = x0;
+        if (y0 < 0) {
+            x -= y0 * dxdy;
+        }
+
+        auto row_begin = static_cast<size_t>(std::max(0.0, std::floor(y0)));
+        auto row_end = static_cast<size_t>(std::min(static_cast<double>(rows), std::ceil(y1)));
+
+        for (size_t r = row_begin; r < row_end; r++) {
+            double dy = std::min(static_cast<double>(r + 1), y1) - std::max(static_cast<double>(r), y0);
+            double xnext = x + dxdy * dy;
+            double d = dy * dir;
+
+            double xa = std::min(x, xnext);
+            double xb = std::max(x, xnext);
+            double xa_floor = std::floor(xa);
+            double xb_ceil = std::ceil(xb);
+            auto ia = static_cast<size_t>(xa_floor);
+            auto ib = static_cast<size_t>(xb_ceil);
+
+            if (ib <= ia + 1) {
+                // Segment lies within a single column of this row
+                double xmf = 0.5 * (x + xnext) - xa_floor;
+                add(r, ia, d - d * xmf);
+                add(r, ia + 1, d * xmf);
+            } else {
+                double s = 1 / (xb - xa);
+                double xaf = xa - xa_floor;
+                double a0 = 0.5 * s * (1 - xaf) * (1 - xaf);
+                double xbf = xb - xb_ceil + 1;
+                double am = 0.5 * s * xbf * xbf;
+
+                add(r, ia, d * a0);
+                if (ib == ia + 2) {
+                    add(r, ia + 1, d * (1 - a0 - am));
+                } else {
+                    double a1 = s * (1.5 - xaf);
+                    add(r, ia + 1, d * (a1 - a0));
+                    for (size_t i = ia + 2; i < ib - 1; i++) {
+                        add(r, i, d * s);
+                    }
+                    double a2 = a1 + static_cast<double>(ib - ia - 3) * s;
+                    add(r, ib - 1, d * (1 - a2 - am));
+                }
+                add(r, ib, d * am);
+            }
+
+            x = xnext;
+        }
+    }
+
+    // Accumulate a segment given in cell units, projecting the portions of the
+    // segment that fall to the left or right of the grid onto its edges. This
+    // preserves their contribution to the cells on their right.
+    template<typename F>
+    static void accumulate_clipped(double x0, double y0, double x1, double y1, size_t rows, size_t cols, F && add) {
+        double w = static_cast<double>(cols);
+
+        double ts[4];
+        size_t n = 0;
+        ts[n++] = 0;
+        if (x0 != x1) {
+            for (double xc : {0.0, w}) {
+                double t = (xc - x0) / (x1 - x0);
+                if (t > 0 && t < 1) {
+                    ts[n++] = t;
+                }
+            }
+        }
+        ts[n++] = 1;
+        std::sort(ts, ts + n);
+
+        for (size_t i = 0; i + 1 < n; i++) {
+            double xa = x0 + ts[i] * (x1 - x0);
+            double ya = y0 + ts[i] * (y1 - y0);
+            double xb = x0 + ts[i + 1] * (x1 - x0);
+            double yb = y0 + ts[i + 1] * (y1 - y0);
+
+            if (i == 0) {
+                xa = x0;
+                ya = y0;
+            }
+            if (i + 2 == n) {
+                xb = x1;
+                yb = y1;
+            }
+
+            accumulate_segment(std::min(std::max(xa, 0.0), w), ya,
+                               std::min(std::max(xb, 0.0), w), yb,
+                               rows, add);
+        }
+    }
+
+    std::vector<Raster<float>> shared_edge_coverage(const Grid<bounded_extent> & grid,
+                                                    const std::vector<const FlatGeometry*> & polygons) {
+        std::vector<Accumulator> accumulators;
+        accumulators.reserve(polygons.size());
+
+        size_t num_edges = 0;
+        for (const auto* g : polygons) {
+            Accumulator acc{g->empty() ? Grid<bounded_extent>::make_empty() : grid.crop(g->box()), 0, 0, {}};
+            if (!acc.grid.empty()) {
+                acc.row0 = grid.row_offset(acc.grid);
+                acc.col0 = grid.col_offset(acc.grid);
+                acc.cells.resize(acc.grid.rows() * (acc.grid.cols() + 1));
+                num_edges += g->num_coordinates();
+            }
+            accumulators.push_back(std::move(acc));
+        }
+
+        // Collect the distinct edges of all polygons, noting the polygons on
+        // either side of each.
+        std::vector<Edge> edges;
+        edges.reserve(num_edges);
+        std::unordered_map<EdgeKey, size_t, EdgeKeyHash> edge_index;
+        edge_index.reserve(num_edges);
+
+        for (size_t p = 0; p < polygons.size(); p++) {
+            if (accumulators[p].cells.empty()) {
+                continue;
+            }
+
+            const FlatGeometry& g = *polygons[p];
+            for (size_t i = 0; i < g.num_polygons(); i++) {
+                for (size_t r = g.first_ring(i); r < g.end_ring(i); r++) {
+                    auto ring = g.ring(r);
+
+                    // Orient the contributions of each ring so that the
+                    // interior of the polygon has positive coverage.
+                    // area_signed is negative for counter-clockwise rings
+                    double sign = area_signed(ring) < 0 ? 1 : -1;
+                    if (r != g.first_ring(i)) {
+                        sign = -sign;
+                    }
+
+                    for (size_t k = 1; k < ring.size(); k++) {
+                        const Coordinate& c0 = ring[k - 1];
+                        const Coordinate& c1 = ring[k];
+
+                        if (c0.y == c1.y) {
+                            continue;
+                        }
+
+                        bool forward = c0.y < c1.y;
+                        EdgeKey key = forward ? EdgeKey{c0, c1} : EdgeKey{c1, c0};
+                        Owner owner{p, forward ? sign : -sign};
+
+                        auto it = edge_index.find(key);
+                        if (it != edge_index.end() && edges[it->second].num_owners < 2) {
+                            Edge& e = edges[it->second];
+                            e.owners[e.num_owners++] = owner;
+                        } else {
+                            edges.push_back(Edge{key.a, key.b, {owner, owner}, 1});
+                            edge_index[key] = edges.size() - 1;
+                        }
+                    }
+                }
+            }
+        }
+
+        // Accumulate each edge once, adding its contributions to the polygon
+        // on each side.
+        for (const auto& e : edges) {
+            double x0 = (e.a.x - grid.xmin()) / grid.dx();
+            double y0 = (grid.ymax() - e.a.y) / grid.dy();
+            double x1 = (e.b.x - grid.xmin()) / grid.dx();
+            double y1 = (grid.ymax() - e.b.y) / grid.dy();
+
+            accumulate_clipped(x0, y0, x1, y1, grid.rows(), grid.cols(), [&](size_t row, size_t col, double value) {
+                for (size_t i = 0; i < e.num_owners; i++) {
+                    accumulators[e.owners[i].polygon].add(row, col, e.owners[i].sign * value);
+                }
+            });
+        }
+
+        // Sum the accumulated values across each row to obtain the covered
+        // fraction of each cell. The contributions of edges do not cancel
+        // exactly, so sums within a small tolerance of 0 or 1 are snapped,
+        // leaving no coverage in cells that the polygon does not cover.
+        constexpr double tolerance = 1e-9;
+
+        std::vector<Raster<float>> coverage;
+        coverage.reserve(polygons.size());
+
+        for (auto& acc : accumulators) {
+            Raster<float> r(acc.grid);
+            size_t stride = acc.grid.cols() + 1;
+
+            for (size_t i = 0; i < acc.grid.rows(); i++) {
+                double sum = 0;
+                for (size_t j = 0; j < acc.grid.cols(); j++) {
+                    sum += acc.cells[i * stride + j];
+
+                    double frac = sum;
+                    if (frac < tolerance) {
+                        frac = 0;
+                    } else if (frac > 1 - tolerance) {
+                        frac = 1;
+                    }
+                    r(i, j) = static_cast<float>(frac);
+                }
+            }
+
+            acc.cells = std::vector<double>();
+            coverage.push_back(std::move(r));
+        }
+
+        return coverage;
+    }
+
+}
@@ -0,0 +1,43 @@
+// Copyright (c) 2021 ISciences, LLC.
+// All rights reserved.
+//
+// This software is licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License. You may
+// obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0.
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef EXACTEXTRACT_SHARED_EDGE_COVERAGE_H
+#define EXACTEXTRACT_SHARED_EDGE_COVERAGE_H
+
+#include <vector>
+
+#include "flat_geometry.h"
+#include "grid.h"
+#include "raster.h"
+
+namespace exactextract {
+
+    /**
+     * Compute the fraction of each cell of `grid` that is covered by each of
+     * `polygons`, returning one raster per polygon with the extent of the
+     * polygon's envelope cropped to the grid.
+     *
+     * Coverage is computed by accumulating the signed area to the right of
+     * each edge, row by row, and summing the accumulated values across each
+     * row, so that interior cells require no separate point-in-polygon test.
+     * An edge shared by two polygons, as in a polygon coverage where
+     * neighbouring polygons have identical vertices along their common
+     * boundary, contributes equal and opposite values to the two polygons and
+     * is processed only once.
+     */
+    std::vector<Raster<float>> shared_edge_coverage(const Grid<bounded_extent> & grid,
+                                                    const std::vector<const FlatGeometry*> & polygons);
+
+}
+
+#endif //EXACTEXTRACT_SHARED_EDGE_COVERAGE_H
@@ -1,4 +1,4 @@
-// Copyright (c) 2019 ISciences, LLC.
+// Copyright (c) 2019-2020 ISciences, LLC.
 // All rights reserved.
 //
 // This software is licensed under the Apache License, Version 2.0 (the "License").
@@ -14,59 +14,236 @@
 #ifndef EXACTEXTRACT_STATS_REGISTRY_H
 #define EXACTEXTRACT_STATS_REGISTRY_H
 
-#include <string>
+#include <stdexcept>
 #include <unordered_map>
+#include <vector>
 
+#include "feature_id.h"
 #include "operation.h"
 #include "raster_stats.h"
 
 namespace exactextract {
 
+    /**
+     * The stats for a single feature, copied from a StatsRegistry so that
+     * they can be handed to another thread after the feature has been
+     * flushed from the registry.
+     */
+    struct FeatureResult {
+        struct Entry {
+            RasterSource* values;
+            RasterSource* weights;
+            RasterStats<double> stats;
+        };
+
+        FeatureId id;
+        std::vector<Entry> entries;
+    };
+
+    /**
+     * Stores the RasterStats for each feature and each group of operations
+     * that share the same value and weighting rasters.
+     *
+     * Each feature is assigned a dense integer slot, which is recycled when
+     * the feature is flushed. Each operation group has a column of RasterStats
+     * indexed by slot, so that looking up the stats for a feature and operation
+     * requires a single hash of the feature ID and no string construction.
+     */
     class StatsRegistry {
     public:
-        RasterStats<double> &stats(const std::string &feature, const Operation &op) {
-            // TODO come up with a better storage method.
-            return m_feature_stats[feature][op_key(op)];
+        /**
+         * Register an operation, so that the stats for its group retain any
+         * values the operation requires. Operations that are not registered
+         * are added when their stats are first requested.
+         */
+        void add_operation(const Operation & op) {
+            OpGroup& g = m_groups[group(op)];
+
+            if (op.requires_stored_values() && !g.store_values) {
+                if (!m_slots.empty()) {
+                    throw std::runtime_error("Operations must be registered before stats are computed.");
+                }
+                g.store_values = true;
+            }
         }
 
-        const RasterStats<double> &stats(const std::string &feature, const Operation &op) const {
-            // TODO come up with a better storage method.
-            return m_feature_stats.at(feature).at(op_key(op));
+        /**
+         * Return the stats for a feature and operation, creating them if
+         * necessary. The returned reference may be invalidated by subsequent
+         * calls to non-const methods.
+         */
+        RasterStats<double> &stats(const FeatureId &feature, const Operation &op) {
+            return stats(group(op), feature);
         }
 
-        bool contains (const std::string & feature, const Operation & op) const {
-            const auto& m = m_feature_stats;
+        const RasterStats<double> &stats(const FeatureId &feature, const Operation &op) const {
+            size_t i = find_group(op);
+            auto it = m_slots.find(feature);
 
-            auto it = m.find(feature);
+            if (i == m_groups.size() || it == m_slots.end() || !m_groups[i].contains(it->second)) {
+                throw std::out_of_range("No stats for feature " + feature.to_string());
+            }
+
+            return m_groups[i].stats[it->second];
+        }
 
-            if (it == m.end()) {
+        bool contains (const FeatureId & feature, const Operation & op) const {
+            size_t i = find_group(op);
+            if (i == m_groups.size()) {
                 return false;
             }
 
-            const auto& m2 = it->second;
+            auto it = m_slots.find(feature);
+            if (it == m_slots.end()) {
+                return false;
+            }
 
-            return m2.find(op_key(op)) != m2.end();
+            return m_groups[i].contains(it->second);
         }
 
-        void flush_feature(const std::string &fid) {
-            std::unordered_map<std::string, double> vals;
-            // TODO assemble vals;
+        /**
+         * Combine the stats of feature `from` in `other`, for all operations,
+         * into the stats of feature `to` in this registry.
+         */
+        void combine(const FeatureId &to, const StatsRegistry &other, const FeatureId &from) {
+            auto it = other.m_slots.find(from);
+            if (it == other.m_slots.end()) {
+                return;
+            }
 
-            m_feature_stats.erase(fid);
+            for (const auto& src : other.m_groups) {
+                if (src.contains(it->second)) {
+                    stats(group(src.values, src.weights, src.store_values), to).combine(src.stats[it->second]);
+                }
+            }
         }
 
-        std::string op_key(const Operation & op) const {
-            if (op.weighted()) {
-                return op.values->name() + "|" + op.weights->name();
-            } else {
-                return op.values->name();
+        /**
+         * Return a copy of the stats of feature `fid`, for all operations,
+         * that does not refer to the registry's storage.
+         */
+        FeatureResult result(const FeatureId &fid) const {
+            FeatureResult ret{fid, {}};
+
+            auto it = m_slots.find(fid);
+            if (it == m_slots.end()) {
+                return ret;
+            }
+
+            for (const auto& g : m_groups) {
+                if (g.contains(it->second)) {
+                    ret.entries.push_back(FeatureResult::Entry{g.values, g.weights, RasterStats<double>(g.store_values)});
+                    ret.entries.back().stats.combine(g.stats[it->second]);
+                }
+            }
+
+            return ret;
+        }
+
+        /** Add the stats of a feature obtained from result(). */
+        void insert(FeatureResult && result) {
+            for (auto& entry : result.entries) {
+                bool store_values = entry.stats.stores_values();
+                stats(group(entry.values, entry.weights, store_values), result.id) = std::move(entry.stats);
             }
         }
 
+        void flush_feature(const FeatureId &fid) {
+            auto it = m_slots.find(fid);
+            if (it == m_slots.end()) {
+                return;
+            }
+
+            size_t slot = it->second;
+            for (auto& g : m_groups) {
+                if (g.contains(slot)) {
+                    // Release any memory held by the stats
+                    g.stats[slot] = RasterStats<double>(g.store_values);
+                    g.present[slot] = false;
+                }
+            }
+
+            m_slots.erase(it);
+            m_free_slots.push_back(slot);
+        }
 
     private:
-        std::unordered_map<std::string,
-        std::unordered_map<std::string, RasterStats <double>>> m_feature_stats{};
+        struct OpGroup {
+            RasterSource* values;
+            RasterSource* weights;
+            bool store_values;
+            std::vector<RasterStats<double>> stats;
+            std::vector<bool> present;
+
+            bool contains(size_t slot) const {
+                return slot < present.size() && present[slot];
+            }
+        };
+
+        size_t find_group(const RasterSource* values, const RasterSource* weights) const {
+            // There are few groups, so a linear search is faster than hashing.
+            size_t i = 0;
+            for (; i < m_groups.size(); i++) {
+                if (m_groups[i].values == values && m_groups[i].weights == weights) {
+                    break;
+                }
+            }
+            return i;
+        }
+
+        size_t find_group(const Operation & op) const {
+            return find_group(op.values, op.weights);
+        }
+
+        size_t group(RasterSource* values, RasterSource* weights, bool store_values) {
+            size_t i = find_group(values, weights);
+
+            if (i == m_groups.size()) {
+                m_groups.push_back(OpGroup{values, weights, store_values, {}, {}});
+            }
+
+            return i;
+        }
+
+        size_t group(const Operation & op) {
+            return group(op.values, op.weights, op.requires_stored_values());
+        }
+
+        RasterStats<double> &stats(size_t group_index, const FeatureId &feature) {
+            OpGroup& g = m_groups[group_index];
+            size_t slot = feature_slot(feature);
+
+            while (g.stats.size() <= slot) {
+                g.stats.emplace_back(g.store_values);
+                g.present.push_back(false);
+            }
+
+            g.present[slot] = true;
+            return g.stats[slot];
+        }
+
+        size_t feature_slot(const FeatureId & feature) {
+            auto it = m_slots.find(feature);
+            if (it != m_slots.end()) {
+                return it->second;
+            }
+
+            size_t slot;
+            if (m_free_slots.empty()) {
+                slot = m_next_slot++;
+            } else {
+                slot = m_free_slots.back();
+                m_free_slots.pop_back();
+            }
+
+            m_slots.emplace(feature, slot);
+            return slot;
+        }
+
+        std::vector<OpGroup> m_groups;
+        std::unordered_map<FeatureId, size_t> m_slots;
+        std::vector<size_t> m_free_slots;
+        size_t m_next_slot = 0;
     };
 
 }
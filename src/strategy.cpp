@@ -0,0 +1,78 @@
+// Copyright (c) 2021 ISciences, LLC.
+// All rights reserved.
+//
+// This software is licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License. You may
+// obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0.
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "strategy.h"
+
+#include <algorithm>
+
+namespace exactextract {
+
+    // Number of cells in the blocks of `grid` touched by `box`.
+    static double block_cells(const Grid<bounded_extent> & grid, const Box & box, size_t block_rows, size_t block_cols) {
+        if (box == Box::make_empty()) {
+            return 0;
+        }
+
+        auto cropped = grid.crop(box);
+        if (cropped.empty()) {
+            return 0;
+        }
+
+        auto aligned = [](size_t begin, size_t end, size_t block, size_t limit) {
+            size_t first = begin / block * block;
+            size_t last = std::min(limit, (end + block - 1) / block * block);
+            return static_cast<double>(last - first);
+        };
+
+        size_t row0 = grid.row_offset(cropped);
+        size_t col0 = grid.col_offset(cropped);
+
+        return aligned(row0, row0 + cropped.rows(), block_rows, grid.rows()) *
+               aligned(col0, col0 + cropped.cols(), block_cols, grid.cols());
+    }
+
+    StrategyEstimate choose_strategy(const Grid<bounded_extent> & grid,
+                                     const Box & features_extent,
+                                     const std::vector<Box> & sample_envelopes,
+                                     size_t num_features,
+                                     size_t block_rows,
+                                     size_t block_cols,
+                                     size_t max_cells_in_memory) {
+        block_rows = std::max<size_t>(block_rows, 1);
+        block_cols = std::max<size_t>(block_cols, 1);
+
+        StrategyEstimate est{};
+
+        double sampled = 0;
+        for (const auto& box : sample_envelopes) {
+            sampled += block_cells(grid, box, block_rows, block_cols);
+        }
+        if (!sample_envelopes.empty()) {
+            est.feature_sequential_cells = sampled / static_cast<double>(sample_envelopes.size()) * static_cast<double>(num_features);
+        }
+
+        for (const auto& subgrid : subdivide(grid, max_cells_in_memory)) {
+            if (!(features_extent == Box::make_empty()) && subgrid.extent().intersects(features_extent)) {
+                est.raster_sequential_cells += block_cells(grid, subgrid.extent(), block_rows, block_cols);
+                est.num_subgrids++;
+            }
+        }
+
+        // Raster-sequential processing must hold every feature in memory (or
+        // spill them to disk), so it is only chosen when it reads less.
+        est.strategy = est.raster_sequential_cells < est.feature_sequential_cells ? "raster-sequential" : "feature-sequential";
+
+        return est;
+    }
+
+}
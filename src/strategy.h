@@ -0,0 +1,57 @@
+// Copyright (c) 2021 ISciences, LLC.
+// All rights reserved.
+//
+// This software is licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License. You may
+// obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0.
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef EXACTEXTRACT_STRATEGY_H
+#define EXACTEXTRACT_STRATEGY_H
+
+#include <string>
+#include <vector>
+
+#include "box.h"
+#include "grid.h"
+
+namespace exactextract {
+
+    struct StrategyEstimate {
+        std::string strategy;
+
+        /** Estimated number of raster cells decoded by each strategy. */
+        double feature_sequential_cells;
+        double raster_sequential_cells;
+
+        /** Number of subgrids read by the raster-sequential strategy. */
+        size_t num_subgrids;
+    };
+
+    /**
+     * Estimate the number of raster cells that must be decoded to process a
+     * layer of `num_features` features with each processing strategy, and
+     * choose the cheaper one.
+     *
+     * The feature-sequential estimate extrapolates from `sample_envelopes`,
+     * a sample of the envelopes of the layer's features, assuming that each
+     * read decodes every block touched by a feature's envelope. The
+     * raster-sequential estimate counts the blocks of each subgrid of at most
+     * `max_cells_in_memory` cells that intersects `features_extent`.
+     */
+    StrategyEstimate choose_strategy(const Grid<bounded_extent> & grid,
+                                     const Box & features_extent,
+                                     const std::vector<Box> & sample_envelopes,
+                                     size_t num_features,
+                                     size_t block_rows,
+                                     size_t block_cols,
+                                     size_t max_cells_in_memory);
+
+}
+
+#endif //EXACTEXTRACT_STRATEGY_H
@@ -44,6 +44,23 @@ public:
         t += w * (x - mean_old) * (x - mean);
     }
 
+    /** \brief Update variance estimate with the values processed by
+     * another instance, using the pairwise formula of Chan, Golub and
+     * LeVeque (1979).
+     */
+    void combine(const WestVariance & other) {
+        if (other.sum_w == 0) {
+            return;
+        }
+
+        double sum_w_new = sum_w + other.sum_w;
+        double delta = other.mean - mean;
+
+        t += other.t + delta * delta * sum_w * other.sum_w / sum_w_new;
+        mean += delta * other.sum_w / sum_w_new;
+        sum_w = sum_w_new;
+    }
+
     /** \brief Return the population variance.
      */
     constexpr double variance() const {
@@ -0,0 +1,39 @@
+#ifndef EXACTEXTRACT_MEM_FILE_H
+#define EXACTEXTRACT_MEM_FILE_H
+
+#include <string>
+
+#include <cpl_vsi.h>
+#include <gdal.h>
+
+#include "catch.hpp"
+
+namespace exactextract {
+
+    // File in /vsimem/ with the given contents, removed when the test is done
+    class MemFile {
+    public:
+        MemFile(std::string name, const std::string & contents) : m_name{std::move(name)} {
+            GDALAllRegister();
+
+            VSILFILE* f = VSIFOpenL(m_name.c_str(), "wb");
+            REQUIRE( f != nullptr );
+            VSIFWriteL(contents.data(), 1, contents.size(), f);
+            VSIFCloseL(f);
+        }
+
+        ~MemFile() {
+            VSIUnlink(m_name.c_str());
+        }
+
+        const std::string& name() const {
+            return m_name;
+        }
+
+    private:
+        std::string m_name;
+    };
+
+}
+
+#endif //EXACTEXTRACT_MEM_FILE_H
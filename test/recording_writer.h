@@ -0,0 +1,59 @@
+#ifndef EXACTEXTRACT_RECORDING_WRITER_H
+#define EXACTEXTRACT_RECORDING_WRITER_H
+
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "output_writer.h"
+#include "stats_registry.h"
+
+namespace exactextract {
+
+    // OutputWriter that records the IDs of the features written to it, along
+    // with the sum computed by each operation.
+    class RecordingWriter : public OutputWriter {
+    public:
+        void write(const FeatureId & fid) override {
+            if (fid == fail_on) {
+                throw std::runtime_error("Failed to write " + fid.to_string());
+            }
+
+            ids.push_back(fid);
+            for (const auto& op : m_ops) {
+                sums.push_back(m_reg->contains(fid, *op) ? static_cast<double>(m_reg->stats(fid, *op).sum()) : -1);
+            }
+        }
+
+        void add_operation(const Operation & op) override {
+            m_ops.push_back(&op);
+        }
+
+        void set_registry(const StatsRegistry* reg) override {
+            m_reg = reg;
+        }
+
+        void finish() override {
+            finished = true;
+        }
+
+        // Sums of a writer with a single operation, keyed by feature ID
+        std::map<std::string, double> sums_by_name() const {
+            std::map<std::string, double> ret;
+            for (size_t i = 0; i < ids.size(); i++) {
+                ret[ids[i].to_string()] = sums.at(i);
+            }
+            return ret;
+        }
+
+        const StatsRegistry* m_reg = nullptr;
+        std::vector<FeatureId> ids;
+        std::vector<double> sums;   // for each feature written, the sum for each operation, or -1 if none
+        FeatureId fail_on{"none"};  // throw when writing this feature
+        bool finished = false;
+    };
+
+}
+
+#endif //EXACTEXTRACT_RECORDING_WRITER_H
@@ -0,0 +1,39 @@
+#include "catch.hpp"
+
+#include "area.h"
+
+using namespace exactextract;
+
+TEST_CASE("Area of ring clipped to box", "[area]") {
+    std::vector<Coordinate> scratch;
+    Box box{0, 0, 1, 1};
+
+    SECTION("Ring inside box") {
+        std::vector<Coordinate> ring{{0.2, 0.2}, {0.8, 0.2}, {0.5, 0.8}, {0.2, 0.2}};
+        CHECK( clipped_area(CoordinateRange(ring), box, scratch) == Approx(area(ring)) );
+    }
+
+    SECTION("Ring containing box") {
+        std::vector<Coordinate> ring{{-1, -1}, {2, -1}, {2, 2}, {-1, 2}, {-1, -1}};
+        CHECK( clipped_area(CoordinateRange(ring), box, scratch) == Approx(1) );
+    }
+
+    SECTION("Ring disjoint from box") {
+        std::vector<Coordinate> ring{{2, 2}, {3, 2}, {3, 3}, {2, 2}};
+        CHECK( clipped_area(CoordinateRange(ring), box, scratch) == 0 );
+    }
+
+    SECTION("Ring crossing box, either orientation") {
+        std::vector<Coordinate> ring{{0.5, -0.25}, {1.25, 0.5}, {0.5, 1.25}, {-0.25, 0.5}, {0.5, -0.25}};
+        CHECK( clipped_area(CoordinateRange(ring), box, scratch) == Approx(0.875) );
+
+        std::vector<Coordinate> reversed(ring.rbegin(), ring.rend());
+        CHECK( clipped_area(CoordinateRange(reversed), box, scratch) == Approx(0.875) );
+    }
+
+    SECTION("Non-convex ring entering box twice") {
+        // U shape whose arms pass through the box, joined outside of it
+        std::vector<Coordinate> ring{{0.1, -1}, {0.9, -1}, {0.9, 2}, {0.7, 2}, {0.7, 0}, {0.3, 0}, {0.3, 2}, {0.1, 2}, {0.1, -1}};
+        CHECK( clipped_area(CoordinateRange(ring), box, scratch) == Approx(0.4) );
+    }
+}
@@ -0,0 +1,78 @@
+#include <stdexcept>
+#include <vector>
+
+#include "catch.hpp"
+
+#include "async_writer.h"
+#include "grid.h"
+#include "in_memory_raster_source.h"
+#include "recording_writer.h"
+
+using namespace exactextract;
+
+TEST_CASE("Async writer writes results in order after they are flushed", "[async-writer]") {
+    Grid<bounded_extent> grid{{0, 0, 2, 2}, 1, 1};
+    std::vector<double> values{1, 2, 3, 4};
+    InMemoryRasterSource<double> src{values.data(), grid};
+    src.set_name("v");
+    auto rast = src.read_box(grid.extent());
+
+    Operation sum("sum", "v_sum", &src);
+    Operation mode("majority", "v_majority", &src);
+
+    RecordingWriter out;
+    AsyncWriter writer(out, 2);
+
+    StatsRegistry reg;
+    writer.set_registry(&reg);
+    writer.add_operation(sum);
+    writer.add_operation(mode);
+    reg.add_operation(sum);
+    reg.add_operation(mode);
+
+    std::vector<FeatureId> expected_ids;
+    std::vector<double> expected_sums;
+
+    for (int64_t id = 1; id <= 100; id++) {
+        Matrix<float> cov(2, 2);
+        cov(static_cast<size_t>(id % 4) / 2, static_cast<size_t>(id % 4) % 2) = 1;
+        reg.stats(FeatureId(id), sum).process(Raster<float>{std::move(cov), grid}, *rast);
+
+        writer.write(FeatureId(id));
+        reg.flush_feature(FeatureId(id));
+
+        expected_ids.emplace_back(id);
+        expected_sums.push_back(static_cast<double>(id % 4 + 1));
+        expected_sums.push_back(static_cast<double>(id % 4 + 1));
+    }
+
+    writer.finish();
+
+    CHECK( out.finished );
+    CHECK( out.ids == expected_ids );
+    CHECK( out.sums == expected_sums );
+}
+
+TEST_CASE("Async writer reports errors from the wrapped writer", "[async-writer]") {
+    Grid<bounded_extent> grid{{0, 0, 2, 2}, 1, 1};
+    std::vector<double> values{1, 2, 3, 4};
+    InMemoryRasterSource<double> src{values.data(), grid};
+    src.set_name("v");
+
+    Operation sum("sum", "v_sum", &src);
+
+    RecordingWriter out;
+    out.fail_on = FeatureId("b");
+    AsyncWriter writer(out, 1);
+
+    StatsRegistry reg;
+    writer.set_registry(&reg);
+    writer.add_operation(sum);
+
+    writer.write(FeatureId("a"));
+    writer.write(FeatureId("b"));
+
+    CHECK_THROWS_WITH( writer.finish(), "Failed to write b" );
+    CHECK( out.ids == std::vector<FeatureId>{FeatureId("a")} );
+    CHECK( !out.finished );
+}
@@ -0,0 +1,93 @@
+#include <cmath>
+#include <vector>
+
+#include "catch.hpp"
+
+#include "cell_writer.h"
+#include "in_memory_raster_source.h"
+
+using namespace exactextract;
+
+namespace {
+    struct CellRecord {
+        size_t row;
+        size_t col;
+        float coverage;
+        double value;
+        double weight;
+    };
+
+    class RecordingCellWriter : public CellWriter {
+    public:
+        std::vector<CellRecord> cells;
+
+    protected:
+        void write_cell(const FeatureId &, const Operation &, size_t row, size_t col, float coverage, double value, double weight) override {
+            cells.push_back({row, col, coverage, value, weight});
+        }
+    };
+}
+
+TEST_CASE("Cell writer writes covered cells with values and weights", "[cell-writer]") {
+    Grid<bounded_extent> grid{{0, 0, 4, 4}, 1, 1};
+
+    std::vector<double> values{
+        1,  2,  3,  4,
+        5,  6,  7,  8,
+        9, 10, -1, 12,
+       13, 14, 15, 16};
+    std::vector<double> weight_values(16, 0.5);
+
+    InMemoryRasterSource<double> values_src{values.data(), grid};
+    InMemoryRasterSource<double> weights_src{weight_values.data(), grid};
+    values_src.set_name("v");
+    weights_src.set_name("w");
+
+    auto vals = values_src.read_box(grid.extent());
+    vals->set_nodata(-1);
+    auto weights = weights_src.read_box(grid.extent());
+
+    // Coverage for the lower-right 2x2 cells of the grid
+    Grid<bounded_extent> cov_grid = grid.crop({2, 0, 4, 2});
+    Matrix<float> cov(2, 2);
+    cov(0, 0) = 0.25f;
+    cov(0, 1) = 1;
+    cov(1, 1) = 0.5f;
+    Raster<float> coverage{std::move(cov), cov_grid};
+
+    RecordingCellWriter writer;
+
+    SECTION("Unweighted") {
+        Operation mean("mean", "v_mean", &values_src);
+        writer.write(FeatureId(1), mean, grid, coverage, *vals, nullptr);
+
+        REQUIRE( writer.cells.size() == 3 );
+
+        // Cell without a value is still written
+        CHECK( writer.cells[0].row == 2 );
+        CHECK( writer.cells[0].col == 2 );
+        CHECK( writer.cells[0].coverage == 0.25f );
+        CHECK( std::isnan(writer.cells[0].value) );
+
+        CHECK( writer.cells[1].row == 2 );
+        CHECK( writer.cells[1].col == 3 );
+        CHECK( writer.cells[1].value == 12 );
+        CHECK( std::isnan(writer.cells[1].weight) );
+
+        // Cell without coverage is skipped
+        CHECK( writer.cells[2].row == 3 );
+        CHECK( writer.cells[2].col == 3 );
+        CHECK( writer.cells[2].coverage == 0.5f );
+        CHECK( writer.cells[2].value == 16 );
+    }
+
+    SECTION("Weighted") {
+        Operation weighted_mean("weighted_mean", "v_weighted_mean", &values_src, &weights_src);
+        writer.write(FeatureId(1), weighted_mean, grid, coverage, *vals, weights.get());
+
+        REQUIRE( writer.cells.size() == 3 );
+        for (const auto& cell : writer.cells) {
+            CHECK( cell.weight == 0.5 );
+        }
+    }
+}
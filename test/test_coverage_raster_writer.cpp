@@ -0,0 +1,106 @@
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "catch.hpp"
+
+#include "coverage_raster_writer.h"
+
+using namespace exactextract;
+
+namespace {
+    class RecordingCoverageRasterWriter : public CoverageRasterWriter {
+    public:
+        using CoverageRasterWriter::CoverageRasterWriter;
+
+        std::vector<Raster<double>> windows;
+
+    protected:
+        void write_window(Raster<double> & window) override {
+            windows.emplace_back(window.grid());
+            for (size_t i = 0; i < window.rows(); i++) {
+                for (size_t j = 0; j < window.cols(); j++) {
+                    windows.back()(i, j) = window(i, j);
+                }
+            }
+        }
+    };
+}
+
+TEST_CASE("Coverage raster combines coverage of features in each window", "[coverage-raster]") {
+    Grid<bounded_extent> window{{0, 0, 3, 2}, 1, 1};
+
+    // Feature 1 covers the left two columns, feature 2 the right two
+    Raster<float> cov1{Matrix<float>{{{1.0f, 0.75f}, {0.5f, 0.25f}}}, window.crop({0, 0, 2, 2})};
+    Raster<float> cov2{Matrix<float>{{{0.25f, 1.0f}, {0.5f, 0.5f}}}, window.crop({1, 0, 3, 2})};
+
+    auto run = [&](CoverageRasterWriter::Method method) {
+        RecordingCoverageRasterWriter writer(method);
+        writer.begin_window(window);
+        writer.add(FeatureId(1), cov1);
+        writer.add(FeatureId(2), cov2);
+        writer.end_window();
+
+        REQUIRE( writer.windows.size() == 1 );
+        CHECK( writer.windows[0].grid() == window );
+        return std::move(writer.windows[0]);
+    };
+
+    SECTION("sum") {
+        auto r = run(CoverageRasterWriter::parse_method("sum"));
+        CHECK( r(0, 0) == 1.0 );
+        CHECK( r(0, 1) == 1.0 );
+        CHECK( r(0, 2) == 1.0 );
+        CHECK( r(1, 0) == 0.5 );
+        CHECK( r(1, 1) == 0.75 );
+        CHECK( r(1, 2) == 0.5 );
+    }
+
+    SECTION("max") {
+        auto r = run(CoverageRasterWriter::parse_method("max"));
+        CHECK( r(0, 1) == 0.75 );
+        CHECK( r(1, 1) == 0.5 );
+        CHECK( r(1, 2) == 0.5 );
+    }
+
+    SECTION("argmax") {
+        auto r = run(CoverageRasterWriter::parse_method("argmax"));
+        CHECK( r(0, 0) == 1 );
+        CHECK( r(0, 1) == 1 );
+        CHECK( r(0, 2) == 2 );
+        CHECK( r(1, 1) == 2 );
+        CHECK( r(1, 2) == 2 );
+    }
+
+    SECTION("argmax leaves uncovered cells as NaN") {
+        RecordingCoverageRasterWriter writer(CoverageRasterWriter::Method::ARGMAX);
+        writer.begin_window(window);
+        writer.add(FeatureId(1), cov1);
+        writer.end_window();
+
+        CHECK( std::isnan(writer.windows[0](0, 2)) );
+    }
+
+    SECTION("argmax requires integer IDs") {
+        RecordingCoverageRasterWriter writer(CoverageRasterWriter::Method::ARGMAX);
+        writer.begin_window(window);
+        CHECK_THROWS( writer.add(FeatureId("a"), cov1) );
+    }
+
+    SECTION("argmax requires IDs that can be stored exactly") {
+        RecordingCoverageRasterWriter writer(CoverageRasterWriter::Method::ARGMAX);
+        writer.begin_window(window);
+
+        int64_t max_id = int64_t{1} << 53;
+        writer.add(FeatureId(max_id), cov1);
+        CHECK_THROWS( writer.add(FeatureId(max_id + 1), cov1) );
+        CHECK_THROWS( writer.add(FeatureId(-max_id - 1), cov1) );
+
+        writer.end_window();
+        CHECK( writer.windows[0](0, 0) == static_cast<double>(max_id) );
+    }
+
+    SECTION("unknown method") {
+        CHECK_THROWS( CoverageRasterWriter::parse_method("mean") );
+    }
+}
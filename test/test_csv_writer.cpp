@@ -0,0 +1,203 @@
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <cpl_vsi.h>
+
+#include "catch.hpp"
+
+#include "csv_writer.h"
+#include "grid.h"
+#include "in_memory_raster_source.h"
+#include "stats_registry.h"
+
+using namespace exactextract;
+
+namespace {
+
+    // Read the contents of a file, removing it afterwards
+    std::string read_and_remove(const std::string & filename, const std::string & prefix = "") {
+        std::string path = prefix + filename;
+        VSILFILE* f = VSIFOpenL(path.c_str(), "rb");
+        REQUIRE( f != nullptr );
+
+        std::string contents;
+        char buf[4096];
+        size_t n;
+        while ((n = VSIFReadL(buf, 1, sizeof(buf), f)) > 0) {
+            contents.append(buf, n);
+        }
+        VSIFCloseL(f);
+        VSIUnlink(filename.c_str());
+
+        return contents;
+    }
+
+    std::vector<std::string> split(const std::string & s, char delim) {
+        std::vector<std::string> parts;
+        std::stringstream ss(s);
+        std::string part;
+        while (std::getline(ss, part, delim)) {
+            parts.push_back(part);
+        }
+        return parts;
+    }
+
+}
+
+TEST_CASE("CSV writer writes a header and a row for each feature", "[csv]") {
+    Grid<bounded_extent> grid{{0, 0, 2, 1}, 1, 1};
+    std::vector<double> values{1, 2};
+    InMemoryRasterSource<double> src{values.data(), grid};
+    src.set_name("v");
+    auto rast = src.read_box(grid.extent());
+
+    Operation sum("sum", "v_sum", &src);
+    Operation mean("mean", "v_mean", &src);
+
+    std::string filename = "/vsimem/test_csv_writer.csv";
+
+    {
+        CSVWriter writer(filename);
+        writer.add_id_field("id", "");
+        writer.add_operation(sum);
+        writer.add_operation(mean);
+
+        StatsRegistry reg;
+        reg.add_operation(sum);
+        reg.add_operation(mean);
+        writer.set_registry(&reg);
+
+        // Covers the second cell
+        Matrix<float> cov(1, 2);
+        cov(0, 1) = 1;
+        reg.stats(FeatureId("a,b"), sum).process(Raster<float>{std::move(cov), grid}, *rast);
+        writer.write(FeatureId("a,b"));
+
+        // Covers no cells, so that its mean is NaN
+        Matrix<float> none(1, 2);
+        reg.stats(FeatureId("say \"hi\""), sum).process(Raster<float>{std::move(none), grid}, *rast);
+        writer.write(FeatureId("say \"hi\""));
+
+        // Has no results
+        writer.write(FeatureId(3));
+
+        writer.finish();
+    }
+
+    CHECK( read_and_remove(filename) ==
+           "id,v_sum,v_mean\n"
+           "\"a,b\",2,2\n"
+           "\"say \"\"hi\"\"\",0,nan\n"
+           "3,,\n" );
+}
+
+TEST_CASE("CSV writer writes a header without any features", "[csv]") {
+    std::string filename = "/vsimem/test_csv_writer_empty.csv";
+
+    {
+        CSVWriter writer(filename);
+        writer.add_id_field("name, with comma", "");
+        writer.finish();
+    }
+
+    CHECK( read_and_remove(filename) == "\"name, with comma\"\n" );
+}
+
+TEST_CASE("CSV values are read back exactly", "[csv]") {
+    std::vector<double> values{
+        0,
+        -0.0,
+        3,
+        -7,
+        0.1,
+        1.0 / 3,
+        0.30000000000000004,
+        123456789.12345679,
+        1e15,
+        9007199254740993.0,
+        -2.5e-300,
+        std::numeric_limits<double>::max(),
+        std::numeric_limits<double>::denorm_min(),
+        std::numeric_limits<double>::infinity(),
+        -std::numeric_limits<double>::infinity()
+    };
+
+    std::string filename = "/vsimem/test_csv_round_trip.csv";
+
+    {
+        CSVFile file(filename);
+        for (double val : values) {
+            file.write_double(val);
+            file.end_row();
+        }
+        file.close();
+    }
+
+    auto lines = split(read_and_remove(filename), '\n');
+    REQUIRE( lines.size() == values.size() );
+
+    for (size_t i = 0; i < values.size(); i++) {
+        double val = std::strtod(lines[i].c_str(), nullptr);
+        CHECK( val == values[i] );
+        CHECK( std::signbit(val) == std::signbit(values[i]) );
+    }
+
+    CHECK( lines[0] == "0" );
+    CHECK( lines[1] == "-0" );
+    CHECK( lines[2] == "3" );
+    CHECK( lines[3] == "-7" );
+    CHECK( lines[4] == "0.1" );
+    CHECK( lines[6] == "0.30000000000000004" );
+    CHECK( lines[13] == "inf" );
+    CHECK( lines[14] == "-inf" );
+}
+
+TEST_CASE("Single-precision CSV values are read back exactly", "[csv]") {
+    std::vector<float> values{0.0f, -0.0f, 1.0f, 0.1f, 1.0f / 3, 16777217.0f, std::numeric_limits<float>::infinity()};
+
+    std::string filename = "/vsimem/test_csv_round_trip_float.csv";
+
+    {
+        CSVFile file(filename);
+        for (float val : values) {
+            file.write_float(val);
+            file.end_row();
+        }
+        file.close();
+    }
+
+    auto lines = split(read_and_remove(filename), '\n');
+    REQUIRE( lines.size() == values.size() );
+
+    for (size_t i = 0; i < values.size(); i++) {
+        float val = std::strtof(lines[i].c_str(), nullptr);
+        CHECK( val == values[i] );
+        CHECK( std::signbit(val) == std::signbit(values[i]) );
+    }
+
+    CHECK( lines[3] == "0.1" );
+}
+
+TEST_CASE("Compressed CSV output can be read back", "[csv]") {
+    std::string filename = "/vsimem/test_csv_writer.csv.gz";
+
+    {
+        CSVFile file(filename);
+        for (int i = 0; i < 100000; i++) {
+            file.write_int(i);
+            file.write_separator();
+            file.write_string("x");
+            file.end_row();
+        }
+        file.close();
+    }
+
+    auto lines = split(read_and_remove(filename, "/vsigzip/"), '\n');
+    REQUIRE( lines.size() == 100000 );
+    CHECK( lines[0] == "0,x" );
+    CHECK( lines[99999] == "99999,x" );
+}
@@ -0,0 +1,90 @@
+#include "catch.hpp"
+
+#include "feature_spill_store.h"
+
+using namespace exactextract;
+
+static FlatGeometry square(double x0, double y0, double size) {
+    FlatGeometry g;
+    g.add_polygon();
+    g.add_ring();
+    g.add_coordinate(x0, y0);
+    g.add_coordinate(x0 + size, y0);
+    g.add_coordinate(x0 + size, y0 + size);
+    g.add_coordinate(x0, y0 + size);
+    g.add_coordinate(x0, y0);
+    return g;
+}
+
+TEST_CASE("Features are read back from their buckets in the order added", "[feature-spill-store]") {
+    for (size_t max_buffered_bytes : {0, 200, 1 << 20}) {
+        FeatureSpillStore store(".", 3, max_buffered_bytes);
+
+        for (int i = 0; i < 20; i++) {
+            store.add(static_cast<size_t>(i % 2), FeatureId(i), square(i, i, 0.5));
+        }
+
+        FlatGeometry multi = square(0, 0, 10);
+        multi.add_ring();
+        for (const auto& c : square(1, 1, 1).ring(0)) {
+            multi.add_coordinate(c.x, c.y);
+        }
+        multi.add_polygon();
+        multi.add_ring();
+        for (const auto& c : square(20, 20, 1).ring(0)) {
+            multi.add_coordinate(c.x, c.y);
+        }
+        store.add(0, "", multi);
+
+        CHECK( store.size(0) == 11 );
+        CHECK( store.size(1) == 10 );
+        CHECK( store.size(2) == 0 );
+
+        int i = 0;
+        store.read(0, [&i, &multi](const FeatureId & name, const FlatGeometry & geom) {
+            if (i < 10) {
+                CHECK( name == FeatureId(2*i) );
+                CHECK( geom.box() == Box(2*i, 2*i, 2*i + 0.5, 2*i + 0.5) );
+            } else {
+                CHECK( name == FeatureId("") );
+                REQUIRE( geom.num_polygons() == 2 );
+                CHECK( geom.first_ring(1) == 2 );
+                CHECK( geom.num_rings() == 3 );
+                CHECK( geom.num_coordinates() == multi.num_coordinates() );
+                CHECK( geom.ring(1)[2] == Coordinate(2, 2) );
+                CHECK( geom.box() == multi.box() );
+            }
+            i++;
+        });
+        CHECK( i == 11 );
+
+        size_t n = 0;
+        store.read(1, [&n](const FeatureId & name, const FlatGeometry &) {
+            CHECK( name == FeatureId(static_cast<int64_t>(2*n + 1)) );
+            n++;
+        });
+        CHECK( n == 10 );
+
+        store.read(2, [](const FeatureId &, const FlatGeometry &) {
+            FAIL( "Empty bucket should have no features" );
+        });
+    }
+}
+
+TEST_CASE("Features can be added to a bucket after it has been read", "[feature-spill-store]") {
+    FeatureSpillStore store(".", 1, 0);
+
+    store.add(0, "a", square(0, 0, 1));
+
+    size_t n = 0;
+    store.read(0, [&n](const FeatureId &, const FlatGeometry &) { n++; });
+    CHECK( n == 1 );
+
+    store.add(0, "b", square(0, 0, 1));
+
+    std::vector<FeatureId> names;
+    store.read(0, [&names](const FeatureId & name, const FlatGeometry &) { names.push_back(name); });
+    REQUIRE( names.size() == 2 );
+    CHECK( names[0] == FeatureId("a") );
+    CHECK( names[1] == FeatureId("b") );
+}
@@ -0,0 +1,219 @@
+#include <cstdint>
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include "catch.hpp"
+
+#include "flat_geometry.h"
+
+using namespace exactextract;
+
+namespace {
+
+    // Minimal WKB writer for constructing test inputs in either byte order
+    class WkbBuilder {
+    public:
+        explicit WkbBuilder(bool little_endian = true) : m_little_endian{little_endian} {}
+
+        WkbBuilder& header(uint32_t type) {
+            m_bytes.push_back(m_little_endian ? 1 : 0);
+            return uint32(type);
+        }
+
+        WkbBuilder& uint32(uint32_t val) {
+            append(&val, sizeof(val));
+            return *this;
+        }
+
+        WkbBuilder& coords(const std::vector<double> & vals) {
+            for (double val : vals) {
+                append(&val, sizeof(val));
+            }
+            return *this;
+        }
+
+        const std::vector<unsigned char>& bytes() const {
+            return m_bytes;
+        }
+
+    private:
+        void append(const void* src, size_t n) {
+            auto p = static_cast<const unsigned char*>(src);
+            std::vector<unsigned char> val(p, p + n);
+
+            uint16_t one = 1;
+            unsigned char first;
+            std::memcpy(&first, &one, 1);
+            bool host_little_endian = first == 1;
+
+            if (host_little_endian != m_little_endian) {
+                std::reverse(val.begin(), val.end());
+            }
+
+            m_bytes.insert(m_bytes.end(), val.begin(), val.end());
+        }
+
+        bool m_little_endian;
+        std::vector<unsigned char> m_bytes;
+    };
+
+    FlatGeometry read(const WkbBuilder & wkb) {
+        return read_wkb(wkb.bytes().data(), wkb.bytes().size());
+    }
+
+}
+
+TEST_CASE("Polygon with hole is read from WKB in either byte order", "[flat-geometry]") {
+    for (bool little_endian : {true, false}) {
+        WkbBuilder wkb(little_endian);
+        wkb.header(3).uint32(2)
+           .uint32(5).coords({0, 0, 10, 0, 10, 10, 0, 10, 0, 0})
+           .uint32(5).coords({2, 2, 2, 4, 4, 4, 4, 2, 2, 2});
+
+        FlatGeometry g = read(wkb);
+
+        CHECK( g.num_polygons() == 1 );
+        CHECK( g.num_rings() == 2 );
+        CHECK( g.num_coordinates() == 10 );
+        CHECK( g.first_ring(0) == 0 );
+        CHECK( g.end_ring(0) == 2 );
+
+        CHECK( g.ring(0).size() == 5 );
+        CHECK( g.ring(1).size() == 5 );
+        CHECK( g.ring(1)[2] == Coordinate(4, 4) );
+
+        CHECK( g.box() == Box(0, 0, 10, 10) );
+    }
+}
+
+TEST_CASE("MultiPolygon and GeometryCollection are read from WKB", "[flat-geometry]") {
+    WkbBuilder wkb;
+    wkb.header(7).uint32(2)
+       .header(6).uint32(2)
+           .header(3).uint32(1).uint32(4).coords({0, 0, 1, 0, 1, 1, 0, 0})
+           .header(3).uint32(1).uint32(4).coords({5, 5, 6, 5, 6, 6, 5, 5})
+       .header(3).uint32(1).uint32(4).coords({-2, -2, -1, -2, -1, -1, -2, -2});
+
+    FlatGeometry g = read(wkb);
+
+    REQUIRE( g.num_polygons() == 3 );
+    CHECK( g.num_rings() == 3 );
+
+    auto boxes = g.component_boxes();
+    REQUIRE( boxes.size() == 3 );
+    CHECK( boxes[0] == Box(0, 0, 1, 1) );
+    CHECK( boxes[1] == Box(5, 5, 6, 6) );
+    CHECK( boxes[2] == Box(-2, -2, -1, -1) );
+
+    CHECK( g.box() == Box(-2, -2, 6, 6) );
+}
+
+TEST_CASE("Z and M values are ignored when reading WKB", "[flat-geometry]") {
+    SECTION("ISO Z") {
+        WkbBuilder wkb;
+        wkb.header(1003).uint32(1).uint32(4).coords({0, 0, 9, 1, 0, 9, 1, 1, 9, 0, 0, 9});
+
+        FlatGeometry g = read(wkb);
+        CHECK( g.ring(0)[1] == Coordinate(1, 0) );
+    }
+
+    SECTION("ISO ZM") {
+        WkbBuilder wkb;
+        wkb.header(3003).uint32(1).uint32(4).coords({0, 0, 9, 8, 1, 0, 9, 8, 1, 1, 9, 8, 0, 0, 9, 8});
+
+        FlatGeometry g = read(wkb);
+        CHECK( g.ring(0)[2] == Coordinate(1, 1) );
+    }
+
+    SECTION("EWKB Z with SRID") {
+        WkbBuilder wkb;
+        wkb.header(0x80000000u | 0x20000000u | 3).uint32(4326)
+           .uint32(1).uint32(4).coords({0, 0, 9, 1, 0, 9, 1, 1, 9, 0, 0, 9});
+
+        FlatGeometry g = read(wkb);
+        CHECK( g.ring(0)[1] == Coordinate(1, 0) );
+        CHECK( g.num_coordinates() == 4 );
+    }
+}
+
+TEST_CASE("Empty polygons are read from WKB", "[flat-geometry]") {
+    WkbBuilder wkb;
+    wkb.header(6).uint32(1).header(3).uint32(0);
+
+    FlatGeometry g = read(wkb);
+
+    CHECK( g.empty() );
+    CHECK( g.num_polygons() == 0 );
+    CHECK( g.component_boxes().empty() );
+}
+
+TEST_CASE("Envelope is computed from WKB without building a geometry", "[flat-geometry]") {
+    for (bool little_endian : {true, false}) {
+        WkbBuilder wkb(little_endian);
+        wkb.header(6).uint32(2)
+           .header(1003).uint32(1).uint32(4).coords({0, 0, 9, 1, 0, 9, 1, 1, 9, 0, 0, 9})
+           .header(3).uint32(1).uint32(4).coords({-2, 5, -1, 5, -1, 6, -2, 5});
+
+        CHECK( wkb_envelope(wkb.bytes().data(), wkb.bytes().size()) == Box(-2, 0, 1, 6) );
+        CHECK( wkb_envelope(wkb.bytes().data(), wkb.bytes().size()) == read(wkb).box() );
+    }
+
+    SECTION("empty") {
+        WkbBuilder wkb;
+        wkb.header(6).uint32(1).header(3).uint32(0);
+
+        CHECK( wkb_envelope(wkb.bytes().data(), wkb.bytes().size()) == Box::make_empty() );
+    }
+
+    SECTION("truncated") {
+        WkbBuilder wkb;
+        wkb.header(3).uint32(1).uint32(4).coords({0, 0, 1, 0, 1, 1});
+
+        CHECK_THROWS( wkb_envelope(wkb.bytes().data(), wkb.bytes().size()) );
+    }
+}
+
+TEST_CASE("Invalid or unsupported WKB is rejected", "[flat-geometry]") {
+    SECTION("unsupported type") {
+        WkbBuilder wkb;
+        wkb.header(1).coords({0, 0});
+
+        CHECK_THROWS_AS( read(wkb), std::invalid_argument );
+    }
+
+    SECTION("truncated") {
+        WkbBuilder wkb;
+        wkb.header(3).uint32(1).uint32(4).coords({0, 0, 1, 0, 1, 1});
+
+        CHECK_THROWS( read(wkb) );
+    }
+
+    SECTION("unclosed ring") {
+        WkbBuilder wkb;
+        wkb.header(3).uint32(1).uint32(4).coords({0, 0, 1, 0, 1, 1, 0, 1});
+
+        CHECK_THROWS( read(wkb) );
+    }
+}
+
+TEST_CASE("Point in ring", "[flat-geometry]") {
+    std::vector<Coordinate> ring{{0, 0}, {4, 0}, {4, 4}, {2, 2}, {0, 4}, {0, 0}};
+    CoordinateRange r(ring);
+
+    CHECK( point_in_ring({1, 1}, r) );
+    CHECK( point_in_ring({3.5, 3}, r) );
+    CHECK_FALSE( point_in_ring({2, 3}, r) );
+    CHECK_FALSE( point_in_ring({5, 1}, r) );
+    CHECK_FALSE( point_in_ring({-1, 2}, r) );
+
+    // boundary
+    CHECK_FALSE( point_in_ring({2, 0}, r) );
+    CHECK_FALSE( point_in_ring({4, 4}, r) );
+    CHECK_FALSE( point_in_ring({3, 3}, r) );
+
+    // orientation does not matter
+    std::vector<Coordinate> reversed(ring.rbegin(), ring.rend());
+    CHECK( point_in_ring({1, 1}, CoordinateRange(reversed)) );
+    CHECK_FALSE( point_in_ring({2, 3}, CoordinateRange(reversed)) );
+}
@@ -0,0 +1,55 @@
+#include <string>
+
+#include "catch.hpp"
+
+#include "gdal_dataset_wrapper.h"
+#include "mem_file.h"
+
+using namespace exactextract;
+
+namespace {
+
+    std::string feature(int id, const std::string & parent, bool has_geometry) {
+        return R"({"type": "Feature", "properties": {"id": )" + std::to_string(id) + R"(, "parent": )" + parent + "}, " +
+               R"("geometry": )" + (has_geometry ? R"({"type": "Polygon", "coordinates": [[[0, 0], [1, 0], [1, 1], [0, 0]]]})" : "null") + "}";
+    }
+
+}
+
+TEST_CASE("Parent IDs are read for every feature with a parent", "[gdal]") {
+    MemFile file("/vsimem/parents.geojson",
+                 R"({"type": "FeatureCollection", "features": [)" +
+                 feature(1, R"("a")", true) + ", " +
+                 feature(2, R"("b")", true) + ", " +
+                 feature(3, "null", true) + ", " +
+                 feature(1, R"("a")", false) + "]}");
+
+    GDALDatasetWrapper ds(file.name(), "0", "id");
+
+    auto parents = ds.read_parent_ids("parent");
+
+    CHECK( parents.size() == 2 );
+    CHECK( parents.at(FeatureId(1)) == FeatureId("a") );
+    CHECK( parents.at(FeatureId(2)) == FeatureId("b") );
+    CHECK( parents.find(FeatureId(3)) == parents.end() );
+    CHECK( parents.find(FeatureId("")) == parents.end() );
+
+    // Geometries are read again afterwards
+    REQUIRE( ds.next() );
+    CHECK( ds.feature_id() == FeatureId(1) );
+    CHECK( ds.feature_envelope() == Box(0, 0, 1, 1) );
+}
+
+TEST_CASE("Features with conflicting parent IDs are rejected", "[gdal]") {
+    MemFile file("/vsimem/conflicting_parents.geojson",
+                 R"({"type": "FeatureCollection", "features": [)" +
+                 feature(1, R"("a")", true) + ", " +
+                 feature(1, R"("b")", true) + "]}");
+
+    GDALDatasetWrapper ds(file.name(), "0", "id");
+
+    CHECK_THROWS_WITH( ds.read_parent_ids("parent"), "Feature 1 has more than one value of parent" );
+
+    REQUIRE( ds.next() );
+    CHECK( ds.feature_envelope() == Box(0, 0, 1, 1) );
+}
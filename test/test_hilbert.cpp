@@ -0,0 +1,61 @@
+#include <cstdlib>
+#include <set>
+
+#include "catch.hpp"
+
+#include "box.h"
+#include "hilbert.h"
+
+using namespace exactextract;
+
+TEST_CASE("Hilbert curve visits every cell once, moving between adjacent cells") {
+    constexpr uint32_t bits = 3;
+    constexpr uint32_t n = 1u << bits;
+
+    std::vector<std::pair<uint32_t, uint32_t>> cells(n*n);
+    std::set<uint32_t> seen;
+
+    for (uint32_t x = 0; x < n; x++) {
+        for (uint32_t y = 0; y < n; y++) {
+            auto d = hilbert_index(x, y, bits);
+            REQUIRE( d < n*n );
+            seen.insert(d);
+            cells[d] = {x, y};
+        }
+    }
+
+    CHECK( seen.size() == n*n );
+
+    for (size_t d = 1; d < cells.size(); d++) {
+        auto dx = std::abs(static_cast<int>(cells[d].first) - static_cast<int>(cells[d-1].first));
+        auto dy = std::abs(static_cast<int>(cells[d].second) - static_cast<int>(cells[d-1].second));
+        CHECK( dx + dy == 1 );
+    }
+}
+
+TEST_CASE("Hilbert ordering keeps nearby boxes together") {
+    std::vector<Box> boxes{
+        {0, 0, 1, 1},
+        {9, 9, 10, 10},
+        {1, 0, 2, 1},
+        {8, 9, 9, 10},
+        {0, 1, 1, 2},
+        Box::make_empty(),
+        {9, 8, 10, 9}
+    };
+
+    auto order = hilbert_order(boxes);
+
+    REQUIRE( order.size() == boxes.size() );
+
+    // Null envelopes come last
+    CHECK( order.back() == 5 );
+
+    // The three boxes near the origin are visited consecutively, as are the
+    // three boxes in the opposite corner.
+    std::set<size_t> first{order[0], order[1], order[2]};
+    std::set<size_t> second{order[3], order[4], order[5]};
+
+    CHECK( first == std::set<size_t>{0, 2, 4} );
+    CHECK( second == std::set<size_t>{1, 3, 6} );
+}
@@ -0,0 +1,57 @@
+#include <cstdint>
+#include <vector>
+
+#include "catch.hpp"
+
+#include "grid.h"
+#include "in_memory_raster_source.h"
+
+using namespace exactextract;
+
+TEST_CASE("InMemoryRasterSource reads a window of a caller-owned buffer") {
+    Grid<bounded_extent> g{{0, 0, 5, 4}, 1, 1};
+
+    std::vector<int16_t> data(g.size());
+    for (size_t i = 0; i < data.size(); i++) {
+        data[i] = static_cast<int16_t>(i);
+    }
+
+    InMemoryRasterSource<int16_t> src(data.data(), g);
+
+    CHECK( src.grid() == g );
+
+    auto r = src.read_box({1, 1, 4, 3});
+
+    CHECK( r->rows() == 2 );
+    CHECK( r->cols() == 3 );
+    CHECK( r->xmin() == 1 );
+    CHECK( r->ymax() == 3 );
+
+    CHECK( (*r)(0, 0) == 6 );
+    CHECK( (*r)(0, 2) == 8 );
+    CHECK( (*r)(1, 0) == 11 );
+    CHECK( (*r)(1, 2) == 13 );
+
+    SECTION("rasters refer to the buffer without copying it") {
+        data[6] = 100;
+        CHECK( (*r)(0, 0) == 100 );
+    }
+}
+
+TEST_CASE("InMemoryRasterSource reports nodata values") {
+    Grid<bounded_extent> g{{0, 0, 2, 2}, 1, 1};
+
+    std::vector<float> data{1.0f, -999.0f, 3.0f, 4.0f};
+
+    InMemoryRasterSource<float> src(data.data(), g, -999.0f);
+
+    auto r = src.read_box(g.extent());
+
+    CHECK( r->has_nodata() );
+    CHECK( r->nodata() == -999.0 );
+
+    double val;
+    CHECK( r->get(0, 0, val) );
+    CHECK( val == 1.0 );
+    CHECK_FALSE( r->get(0, 1, val) );
+}
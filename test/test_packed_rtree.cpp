@@ -0,0 +1,82 @@
+#include <algorithm>
+#include <random>
+
+#include "catch.hpp"
+
+#include "packed_rtree.h"
+
+using namespace exactextract;
+
+static std::vector<size_t> brute_force_query(const std::vector<Box> & boxes, const Box & query) {
+    std::vector<size_t> hits;
+    for (size_t i = 0; i < boxes.size(); i++) {
+        if (!(boxes[i] == Box::make_empty()) && boxes[i].intersects(query)) {
+            hits.push_back(i);
+        }
+    }
+    return hits;
+}
+
+static std::vector<size_t> sorted(std::vector<size_t> v) {
+    std::sort(v.begin(), v.end());
+    return v;
+}
+
+TEST_CASE("Packed R-tree query matches brute force", "[packed-rtree]") {
+    std::default_random_engine eng(1234);
+    std::uniform_real_distribution<double> coord(-180, 180);
+    std::uniform_real_distribution<double> size(0, 5);
+
+    for (size_t n : {0, 1, 2, 15, 16, 17, 257, 5000}) {
+        std::vector<Box> boxes;
+        for (size_t i = 0; i < n; i++) {
+            double x = coord(eng);
+            double y = coord(eng);
+            boxes.emplace_back(x, y, x + size(eng), y + size(eng));
+        }
+
+        PackedRTree tree(boxes);
+        CHECK( tree.size() == n );
+
+        for (int i = 0; i < 50; i++) {
+            double x = coord(eng);
+            double y = coord(eng);
+            Box query{x, y, x + 10*size(eng), y + 10*size(eng)};
+
+            CHECK( sorted(tree.query(query)) == brute_force_query(boxes, query) );
+        }
+
+        // Query covering everything
+        CHECK( tree.query(Box{-200, -200, 200, 200}).size() == n );
+    }
+}
+
+TEST_CASE("Packed R-tree handles degenerate and empty boxes", "[packed-rtree]") {
+    std::vector<Box> boxes{
+        {0, 0, 1, 1},
+        Box::make_empty(),
+        {2, 2, 2, 2},     // point
+        {3, 0, 3, 5},     // vertical line
+        Box::make_empty(),
+    };
+
+    PackedRTree tree(boxes, 2);
+
+    CHECK( tree.size() == 3 );
+
+    CHECK( sorted(tree.query({-1, -1, 10, 10})) == std::vector<size_t>{0, 2, 3} );
+    CHECK( tree.query({2, 2, 2.5, 2.5}) == std::vector<size_t>{2} );
+    CHECK( tree.query({2.5, 1, 3, 1.5}) == std::vector<size_t>{3} );
+
+    // Boxes that only touch are considered to intersect
+    CHECK( tree.query({1, 1, 1.5, 1.5}) == std::vector<size_t>{0} );
+
+    CHECK( tree.query({4, 4, 5, 5}).empty() );
+}
+
+TEST_CASE("Empty packed R-tree returns no results", "[packed-rtree]") {
+    PackedRTree tree;
+
+    CHECK( tree.empty() );
+    CHECK( tree.query({0, 0, 1, 1}).empty() );
+}
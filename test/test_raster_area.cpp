@@ -5,6 +5,7 @@
 #include "grid.h"
 #include "matrix.h"
 #include "raster_area.h"
+#include "raster_area_source.h"
 
 using namespace exactextract;
 
@@ -34,3 +35,33 @@ TEST_CASE("Spherical area raster returns pixel area") {
 
     CHECK( std::abs((areas(4, 3) - postgis_area) / postgis_area) < 0.002 );
 }
+
+TEST_CASE("Area raster source returns areas for a window") {
+    Grid<bounded_extent> g{{0, 40, 10, 60}, 1, 1};
+
+    AreaRasterSource src(g, AreaRasterSource::Method::SPHERICAL);
+    SphericalAreaRaster<double> areas(g);
+
+    CHECK( src.grid() == g );
+
+    auto window = src.read_box({3, 45, 5, 55});
+
+    CHECK( window->rows() == 10 );
+    CHECK( window->cols() == 2 );
+
+    for (size_t i = 0; i < window->rows(); i++) {
+        CHECK( (*window)(i, 1) == areas(i + 5, 4) );
+    }
+}
+
+TEST_CASE("Area raster source computes Cartesian areas") {
+    Grid<bounded_extent> g{{0, 0, 10, 10}, 0.5, 0.25};
+
+    AreaRasterSource src(g, AreaRasterSource::parse_method("cartesian_area"));
+
+    auto window = src.read_box({2, 2, 3, 3});
+
+    CHECK( (*window)(2, 1) == 0.125 );
+
+    CHECK_THROWS( AreaRasterSource::parse_method("geodesic_area") );
+}
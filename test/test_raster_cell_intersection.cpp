@@ -565,3 +565,32 @@ TEST_CASE("Processing region incorporates overlapping area of all component boxe
 
     CHECK( processing_region(raster_extent, component_boxes) == raster_extent );
 }
+
+TEST_CASE("Native polygon representation gives same result as GEOS geometry", "[raster-cell-intersection]") {
+    GEOSContextHandle_t context = init_geos();
+
+    Grid<bounded_extent> ex{{0, 0, 5, 5}, 1, 1}; // 5x5 grid
+
+    std::vector<std::string> wkts{
+        "POLYGON ((0.5 0.5, 2.5 0.5, 2.5 2.5, 0.5 2.5, 0.5 0.5))",
+        "POLYGON ((1.5 0.5, 2.5 1.5, 1.5 2.5, 0.5 1.5, 1.5 0.5))",
+        "POLYGON ((0.5 0.5, 0.6 0.5, 0.6 0.6, 0.5 0.5))",
+        "POLYGON ((0.5 0.2, 2.2 0.2, 2.2 0.4, 0.7 0.4, 0.7 2.2, 2.2 2.2, 2.2 0.6, 2.4 0.6, 2.4 4.8, 0.5 4.8, 0.5 0.2))",
+        "POLYGON ((0.5 0.5, 4.5 0.5, 4.5 5.5, 0.5 5.5, 0.5 0.5), (1.5 1.5, 1.5 3.5, 3.5 3.5, 3.5 1.5, 1.5 1.5))",
+        "MULTIPOLYGON (((0.5 0.5, 1.5 0.5, 1.5 1.5, 0.5 1.5, 0.5 0.5)), ((2.5 2.5, 4.2 2.5, 3 4.7, 2.5 2.5)))"
+    };
+
+    for (const auto& wkt : wkts) {
+        auto g = GEOSGeom_read_r(context, wkt);
+
+        size_t size;
+        unsigned char* wkb = GEOSGeomToWKB_buf_r(context, g.get(), &size);
+        FlatGeometry flat = read_wkb(wkb, size);
+        GEOSFree_r(context, wkb);
+
+        Raster<float> from_geos = raster_cell_intersection(ex, context, g.get());
+        Raster<float> from_flat = raster_cell_intersection(ex, flat);
+
+        CHECK( from_flat == from_geos );
+    }
+}
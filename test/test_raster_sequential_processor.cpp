@@ -0,0 +1,75 @@
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "catch.hpp"
+
+#include "gdal_dataset_wrapper.h"
+#include "grid.h"
+#include "in_memory_raster_source.h"
+#include "mem_file.h"
+#include "raster_sequential_processor.h"
+#include "recording_writer.h"
+
+using namespace exactextract;
+
+namespace {
+
+    std::string square(int id, double xmin, double ymin) {
+        auto c = [](double x, double y) { return "[" + std::to_string(x) + ", " + std::to_string(y) + "]"; };
+        return R"({"type": "Feature", "properties": {"id": )" + std::to_string(id) + "}, " +
+               R"("geometry": {"type": "Polygon", "coordinates": [[)" +
+               c(xmin, ymin) + ", " + c(xmin + 1, ymin) + ", " + c(xmin + 1, ymin + 1) + ", " + c(xmin, ymin + 1) + ", " + c(xmin, ymin) +
+               "]]}}";
+    }
+
+    std::string collection(const std::vector<std::string> & features) {
+        std::string json = R"({"type": "FeatureCollection", "features": [)";
+        for (size_t i = 0; i < features.size(); i++) {
+            json += (i == 0 ? "" : ", ") + features[i];
+        }
+        return json + "]}";
+    }
+
+}
+
+TEST_CASE("Raster-sequential processor writes one row for each feature", "[raster-sequential]") {
+    Grid<bounded_extent> grid{{0, 0, 2, 2}, 1, 1};
+    std::vector<double> values{1, 2, 3, 4};
+    InMemoryRasterSource<double> src{values.data(), grid};
+    src.set_name("v");
+
+    std::vector<Operation> ops{Operation("sum", "v_sum", &src)};
+
+    // Feature 2 falls outside of the raster, so it intersects no subgrid.
+    MemFile file("/vsimem/raster_sequential.geojson",
+                 collection({square(1, 0, 1), square(2, 5, 5), square(3, 1, 0)}));
+    GDALDatasetWrapper ds(file.name(), "0", "id");
+
+    RecordingWriter out;
+    RasterSequentialProcessor proc(ds, out, ops);
+    proc.process();
+
+    CHECK( out.sums_by_name() == std::map<std::string, double>{{"1", 1}, {"2", -1}, {"3", 4}} );
+    CHECK( out.ids.size() == 3 );
+}
+
+TEST_CASE("Raster-sequential processor rejects features with the same ID", "[raster-sequential]") {
+    Grid<bounded_extent> grid{{0, 0, 2, 2}, 1, 1};
+    std::vector<double> values{1, 2, 3, 4};
+    InMemoryRasterSource<double> src{values.data(), grid};
+    src.set_name("v");
+
+    std::vector<Operation> ops{Operation("sum", "v_sum", &src)};
+
+    // The second feature with ID 1 intersects no subgrid, so without the
+    // check it would be dropped silently.
+    MemFile file("/vsimem/raster_sequential_duplicate.geojson",
+                 collection({square(1, 0, 1), square(1, 5, 5), square(3, 1, 0)}));
+    GDALDatasetWrapper ds(file.name(), "0", "id");
+
+    RecordingWriter out;
+    RasterSequentialProcessor proc(ds, out, ops);
+
+    CHECK_THROWS_WITH( proc.process(), Catch::Contains("Feature ID 1 is not unique") );
+}
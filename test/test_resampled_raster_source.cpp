@@ -0,0 +1,106 @@
+#include <cmath>
+#include <vector>
+
+#include "catch.hpp"
+
+#include "grid.h"
+#include "in_memory_raster_source.h"
+#include "resampled_raster_source.h"
+
+using namespace exactextract;
+
+TEST_CASE("Nearest-neighbor resampling onto a non-aligned grid") {
+    Grid<bounded_extent> src_grid{{0, 0, 4, 4}, 1, 1};
+    std::vector<double> data(src_grid.size());
+    for (size_t i = 0; i < data.size(); i++) {
+        data[i] = static_cast<double>(i);
+    }
+    InMemoryRasterSource<double> src(data.data(), src_grid);
+
+    Grid<bounded_extent> target{{0.2, 0.2, 3.2, 3.2}, 1.5, 1.5};
+    CHECK_FALSE( target.compatible_with(src_grid) );
+
+    ResampledRasterSource resampled(src, target, ResampleMethod::NEAREST);
+
+    auto r = resampled.read_box(target.extent());
+
+    REQUIRE( r->rows() == 2 );
+    REQUIRE( r->cols() == 2 );
+
+    // Centers at (0.95, 2.45), (2.45, 2.45), (0.95, 0.95), (2.45, 0.95)
+    CHECK( (*r)(0, 0) == 4 );
+    CHECK( (*r)(0, 1) == 6 );
+    CHECK( (*r)(1, 0) == 12 );
+    CHECK( (*r)(1, 1) == 14 );
+}
+
+TEST_CASE("Area-weighted resampling onto a non-aligned grid") {
+    Grid<bounded_extent> src_grid{{0, 0, 2, 2}, 1, 1};
+    std::vector<double> data{1, 2,
+                             3, 4};
+    InMemoryRasterSource<double> src(data.data(), src_grid);
+
+    SECTION("target cell spanning four source cells") {
+        Grid<bounded_extent> target{{0.5, 0.5, 1.5, 1.5}, 1, 1};
+        ResampledRasterSource resampled(src, target, ResampleMethod::AVERAGE);
+
+        auto r = resampled.read_box(target.extent());
+
+        CHECK( (*r)(0, 0) == Approx(2.5) );
+    }
+
+    SECTION("unequal overlaps are weighted by area") {
+        Grid<bounded_extent> target{{0.5, 1, 1.5, 2}, 1, 1};
+        ResampledRasterSource resampled(src, target, ResampleMethod::AVERAGE);
+
+        auto r = resampled.read_box(target.extent());
+
+        CHECK( (*r)(0, 0) == Approx(1.5) );
+    }
+
+    SECTION("target cells outside the source are undefined") {
+        Grid<bounded_extent> target{{1.5, 1.5, 3.5, 2.5}, 1, 1};
+        ResampledRasterSource resampled(src, target, ResampleMethod::AVERAGE);
+
+        auto r = resampled.read_box(target.extent());
+
+        CHECK( (*r)(0, 0) == Approx(2) );
+        CHECK( std::isnan((*r)(0, 1)) );
+    }
+}
+
+TEST_CASE("Resampling ignores source nodata values") {
+    Grid<bounded_extent> src_grid{{0, 0, 2, 2}, 1, 1};
+    std::vector<float> data{1, -999,
+                            -999, -999};
+    InMemoryRasterSource<float> src(data.data(), src_grid, -999);
+
+    Grid<bounded_extent> target{{0, 0, 2, 2}, 2, 2};
+
+    ResampledRasterSource avg(src, target, ResampleMethod::AVERAGE);
+    CHECK( (*avg.read_box(target.extent()))(0, 0) == 1 );
+
+    ResampledRasterSource nearest(src, {{0.5, 0.5, 1.5, 1.5}, 0.5, 0.5}, ResampleMethod::NEAREST);
+    auto r = nearest.read_box(nearest.grid().extent());
+    CHECK( (*r)(0, 0) == 1 );
+    CHECK( std::isnan((*r)(1, 1)) );
+}
+
+TEST_CASE("Resampled source reuses cached blocks between windows") {
+    Grid<bounded_extent> src_grid{{0, 0, 100, 100}, 1, 1};
+    std::vector<double> data(src_grid.size(), 1.0);
+    InMemoryRasterSource<double> src(data.data(), src_grid);
+
+    Grid<bounded_extent> target{{0, 0, 100, 100}, 0.7, 0.7};
+
+    ResampledRasterSource resampled(src, target, ResampleMethod::AVERAGE, 50, 4);
+
+    resampled.read_box({0, 0, 40, 40});
+    CHECK( resampled.blocks_read() == 1 );
+
+    resampled.read_box({10, 10, 45, 45});
+    CHECK( resampled.blocks_read() == 1 );
+
+    resampled.read_box({0, 0, 100, 100});
+    CHECK( resampled.blocks_read() == 4 );
+}
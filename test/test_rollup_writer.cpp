@@ -0,0 +1,66 @@
+#include <map>
+#include <vector>
+
+#include "catch.hpp"
+
+#include "grid.h"
+#include "in_memory_raster_source.h"
+#include "recording_writer.h"
+#include "rollup_writer.h"
+
+using namespace exactextract;
+
+TEST_CASE("Roll-up writer combines child results into parents", "[rollup]") {
+    Grid<bounded_extent> grid{{0, 0, 2, 2}, 1, 1};
+    std::vector<double> values{1, 2, 3, 4};
+    InMemoryRasterSource<double> src{values.data(), grid};
+    src.set_name("v");
+    auto rast = src.read_box(grid.extent());
+
+    Operation sum("sum", "v_sum", &src);
+
+    // Three levels: cells -> rows -> everything
+    RecordingWriter cells;
+    RecordingWriter rows;
+    RecordingWriter all;
+
+    RollupWriter row_rollup(cells, rows, {{FeatureId(1), FeatureId("top")},
+                                          {FeatureId(2), FeatureId("top")},
+                                          {FeatureId(3), FeatureId("bottom")},
+                                          {FeatureId(4), FeatureId("bottom")}});
+    RollupWriter all_rollup(row_rollup, all, {{FeatureId(1), FeatureId("all")},
+                                              {FeatureId(2), FeatureId("all")},
+                                              {FeatureId(3), FeatureId("all")},
+                                              {FeatureId(4), FeatureId("all")}});
+
+    StatsRegistry reg;
+    all_rollup.set_registry(&reg);
+    all_rollup.add_operation(sum);
+
+    for (int64_t id : {3, 1, 4, 2, 5}) {
+        Matrix<float> cov(2, 2);
+        if (id <= 4) {
+            cov(static_cast<size_t>(id - 1) / 2, static_cast<size_t>(id - 1) % 2) = 1;
+        }
+        reg.stats(FeatureId(id), sum).process(Raster<float>{std::move(cov), grid}, *rast);
+
+        all_rollup.write(FeatureId(id));
+        reg.flush_feature(FeatureId(id));
+    }
+
+    all_rollup.finish();
+
+    CHECK( cells.ids.size() == 5 );
+    CHECK( cells.sums_by_name() == std::map<std::string, double>{{"1", 1}, {"2", 2}, {"3", 3}, {"4", 4}, {"5", 0}} );
+
+    // Parents are written in the order first encountered
+    CHECK( rows.ids == std::vector<FeatureId>{FeatureId("bottom"), FeatureId("top")} );
+    CHECK( rows.sums_by_name() == std::map<std::string, double>{{"bottom", 7}, {"top", 3}} );
+
+    CHECK( all.ids == std::vector<FeatureId>{FeatureId("all")} );
+    CHECK( all.sums_by_name() == std::map<std::string, double>{{"all", 10}} );
+
+    CHECK( cells.finished );
+    CHECK( rows.finished );
+    CHECK( all.finished );
+}
@@ -0,0 +1,153 @@
+#include <random>
+#include <vector>
+
+#include "catch.hpp"
+
+#include "area.h"
+#include "shared_edge_coverage.h"
+
+using namespace exactextract;
+
+static FlatGeometry polygon(const std::vector<std::vector<Coordinate>> & rings) {
+    FlatGeometry g;
+    g.add_polygon();
+    for (const auto& ring : rings) {
+        g.add_ring();
+        for (const auto& c : ring) {
+            g.add_coordinate(c.x, c.y);
+        }
+    }
+    return g;
+}
+
+// Coverage of a cell computed by clipping each ring of a polygon to the cell
+static double expected_coverage(const FlatGeometry & g, const Box & cell) {
+    std::vector<Coordinate> scratch;
+    double covered = 0;
+    for (size_t r = g.first_ring(0); r < g.end_ring(0); r++) {
+        double a = clipped_area(g.ring(r), cell, scratch);
+        covered += r == g.first_ring(0) ? a : -a;
+    }
+    return covered / cell.area();
+}
+
+static void check_coverage(const Grid<bounded_extent> & grid, const FlatGeometry & g, const Raster<float> & coverage) {
+    for (size_t i = 0; i < coverage.rows(); i++) {
+        for (size_t j = 0; j < coverage.cols(); j++) {
+            double x = coverage.grid().x_for_col(j);
+            double y = coverage.grid().y_for_row(i);
+            Box cell = grid_cell(grid, grid.get_row(y), grid.get_column(x));
+
+            CHECK( coverage(i, j) == Approx(expected_coverage(g, cell)).margin(1e-6) );
+        }
+    }
+}
+
+TEST_CASE("Coverage of a single polygon", "[shared-edge-coverage]") {
+    Grid<bounded_extent> grid{{0, 0, 10, 10}, 1, 1};
+
+    std::vector<Coordinate> shell{{0.5, 0.5}, {8.5, 1.5}, {6.25, 9.5}, {1.5, 6.75}, {0.5, 0.5}};
+    std::vector<Coordinate> hole{{3.5, 3.5}, {3.5, 5.25}, {5.5, 5.25}, {5.5, 3.5}, {3.5, 3.5}};
+
+    SECTION("Counter-clockwise shell") {
+        FlatGeometry g = polygon({shell});
+        auto coverage = shared_edge_coverage(grid, {&g});
+
+        REQUIRE( coverage.size() == 1 );
+        CHECK( coverage[0].grid() == grid.crop(g.box()) );
+        check_coverage(grid, g, coverage[0]);
+    }
+
+    SECTION("Clockwise shell with hole") {
+        std::vector<Coordinate> reversed(shell.rbegin(), shell.rend());
+        FlatGeometry g = polygon({reversed, hole});
+        auto coverage = shared_edge_coverage(grid, {&g});
+
+        check_coverage(grid, g, coverage[0]);
+    }
+
+    SECTION("Polygon extending beyond grid") {
+        FlatGeometry g = polygon({{{-3.5, 2.25}, {4.5, -2.5}, {12.5, 4.5}, {5.5, 13.25}, {-3.5, 2.25}}});
+        auto coverage = shared_edge_coverage(grid, {&g});
+
+        CHECK( coverage[0].grid() == grid );
+        check_coverage(grid, g, coverage[0]);
+    }
+
+    SECTION("Polygon outside grid") {
+        FlatGeometry g = polygon({{{20, 20}, {21, 20}, {21, 21}, {20, 20}}});
+        auto coverage = shared_edge_coverage(grid, {&g});
+
+        REQUIRE( coverage.size() == 1 );
+        CHECK( coverage[0].grid().empty() );
+    }
+}
+
+TEST_CASE("Coverage of polygons sharing edges", "[shared-edge-coverage]") {
+    Grid<bounded_extent> grid{{0, 0, 10, 10}, 1, 1};
+
+    // Four polygons dividing the grid, with a shared interior vertex
+    Coordinate c{4.25, 5.75};
+    FlatGeometry sw = polygon({{{0, 0}, {6.5, 0}, c, {0, 3.5}, {0, 0}}});
+    FlatGeometry se = polygon({{{6.5, 0}, {10, 0}, {10, 7.25}, c, {6.5, 0}}});
+    FlatGeometry ne = polygon({{{10, 7.25}, {10, 10}, {2.75, 10}, c, {10, 7.25}}});
+    FlatGeometry nw = polygon({{{0, 3.5}, c, {2.75, 10}, {0, 10}, {0, 3.5}}});
+
+    std::vector<const FlatGeometry*> polygons{&sw, &se, &ne, &nw};
+    auto coverage = shared_edge_coverage(grid, polygons);
+
+    REQUIRE( coverage.size() == polygons.size() );
+
+    for (size_t k = 0; k < polygons.size(); k++) {
+        check_coverage(grid, *polygons[k], coverage[k]);
+    }
+
+    for (size_t i = 0; i < grid.rows(); i++) {
+        for (size_t j = 0; j < grid.cols(); j++) {
+            double x = grid.x_for_col(j);
+            double y = grid.y_for_row(i);
+
+            double total = 0;
+            for (const auto& r : coverage) {
+                if (!r.grid().empty() && r.grid().extent().contains(Coordinate{x, y})) {
+                    total += static_cast<double>(r(r.grid().get_row(y), r.grid().get_column(x)));
+                }
+            }
+
+            CHECK( total == Approx(1) );
+        }
+    }
+}
+
+TEST_CASE("Cells outside of a polygon have no coverage", "[shared-edge-coverage]") {
+    Grid<bounded_extent> grid{{0, 0, 10, 10}, 1, 1};
+
+    std::mt19937 gen(20211017);
+    std::uniform_real_distribution<double> coord(-1, 11);
+
+    for (int k = 0; k < 200; k++) {
+        Coordinate a{coord(gen), coord(gen)};
+        Coordinate b{coord(gen), coord(gen)};
+        Coordinate c{coord(gen), coord(gen)};
+        FlatGeometry g = polygon({{a, b, c, a}});
+
+        auto coverage = shared_edge_coverage(grid, {&g});
+        const auto& r = coverage[0];
+
+        for (size_t i = 0; i < r.rows(); i++) {
+            for (size_t j = 0; j < r.cols(); j++) {
+                double x = r.grid().x_for_col(j);
+                double y = r.grid().y_for_row(i);
+                double expected = expected_coverage(g, grid_cell(grid, grid.get_row(y), grid.get_column(x)));
+
+                // Round-off must not leave a small coverage in cells that
+                // the polygon does not cover, or fall short of full coverage.
+                if (expected == 0) {
+                    CHECK( r(i, j) == 0 );
+                } else if (expected == 1) {
+                    CHECK( r(i, j) == 1 );
+                }
+            }
+        }
+    }
+}
@@ -353,6 +353,24 @@ namespace exactextract {
         CHECK( wv.coefficent_of_variation() == Approx(2.478301) ); // output from Weighted.Desc.Stat::w.sd / Weighted.Desc.Stat::w.mean
     }
 
+    TEST_CASE("Combined variance equals variance of all observations") {
+        std::vector<double> values{3.4, 2.9, 1.7,  8.8, -12.7, 100.4, 8.4, 11.3, 50};
+        std::vector<double> weights{1.0, 0.1, 1.0, 0.2,  0.44,   0.3, 0.3, 0.83,  0};
+
+        WestVariance a, b, empty;
+        for (size_t i = 0; i < values.size(); i++) {
+            (i < 4 ? a : b).process(values[i], weights[i]);
+        }
+
+        empty.combine(a);
+        empty.combine(b);
+        a.combine(b);
+
+        CHECK( a.variance() == Approx(670.8578) );
+        CHECK( a.coefficent_of_variation() == Approx(2.478301) );
+        CHECK( empty.variance() == Approx(670.8578) );
+    }
+
     TEST_CASE("Weighted quantile calculations are correct for equally-weighted inputs") {
         std::vector<double> values{3.4, 2.9, 1.7, 8.8, -12.7, 100.4, 8.4, 11.3};
 
@@ -0,0 +1,152 @@
+#include <vector>
+
+#include "catch.hpp"
+
+#include "grid.h"
+#include "in_memory_raster_source.h"
+#include "stats_registry.h"
+
+using namespace exactextract;
+
+namespace {
+    struct Fixture {
+        Grid<bounded_extent> grid{{0, 0, 2, 2}, 1, 1};
+        std::vector<double> values{1, 2, 2, 3};
+        std::vector<double> weights{1, 1, 1, 1};
+        InMemoryRasterSource<double> values_src{values.data(), grid};
+        InMemoryRasterSource<double> weights_src{weights.data(), grid};
+
+        Raster<float> coverage{Matrix<float>{{{1, 1}, {1, 0.5}}}, grid};
+
+        Fixture() {
+            values_src.set_name("v");
+            weights_src.set_name("w");
+        }
+    };
+}
+
+TEST_CASE("Operations on the same rasters share stats", "[stats-registry]") {
+    Fixture f;
+
+    Operation mean("mean", "v_mean", &f.values_src);
+    Operation sum("sum", "v_sum", &f.values_src);
+    Operation weighted("weighted_mean", "v_wmean", &f.values_src, &f.weights_src);
+
+    StatsRegistry reg;
+
+    CHECK_FALSE( reg.contains(FeatureId(1), mean) );
+
+    reg.stats(FeatureId(1), mean).process(f.coverage, *f.values_src.read_box(f.grid.extent()));
+
+    CHECK( reg.contains(FeatureId(1), mean) );
+    CHECK( reg.contains(FeatureId(1), sum) );
+    CHECK_FALSE( reg.contains(FeatureId(1), weighted) );
+    CHECK_FALSE( reg.contains(FeatureId(2), mean) );
+
+    CHECK( &reg.stats(FeatureId(1), mean) == &reg.stats(FeatureId(1), sum) );
+    CHECK( reg.stats(FeatureId(1), sum).sum() == 6.5f );
+
+    const StatsRegistry& creg = reg;
+    CHECK_THROWS( creg.stats(FeatureId(2), mean) );
+}
+
+TEST_CASE("Integer and string feature IDs are distinct", "[stats-registry]") {
+    Fixture f;
+    Operation count("count", "v_count", &f.values_src);
+
+    StatsRegistry reg;
+    reg.stats(FeatureId(1), count).process(f.coverage, *f.values_src.read_box(f.grid.extent()));
+
+    CHECK( reg.contains(FeatureId(1), count) );
+    CHECK_FALSE( reg.contains(FeatureId("1"), count) );
+}
+
+TEST_CASE("Flushed features are removed and their slots reused", "[stats-registry]") {
+    Fixture f;
+    Operation count("count", "v_count", &f.values_src);
+    auto values = f.values_src.read_box(f.grid.extent());
+
+    StatsRegistry reg;
+
+    reg.stats(FeatureId("a"), count).process(f.coverage, *values);
+    reg.stats(FeatureId("b"), count).process(f.coverage, *values);
+    reg.stats(FeatureId("b"), count).process(f.coverage, *values);
+
+    reg.flush_feature(FeatureId("a"));
+    CHECK_FALSE( reg.contains(FeatureId("a"), count) );
+    CHECK( reg.stats(FeatureId("b"), count).count() == 7.0f );
+
+    // New feature starts with empty stats, even if it reuses a slot
+    CHECK( reg.stats(FeatureId("c"), count).count() == 0.0f );
+
+    // Flushing an unknown feature is harmless
+    reg.flush_feature(FeatureId("z"));
+}
+
+TEST_CASE("Registered operations that need cell values cause values to be stored", "[stats-registry]") {
+    Fixture f;
+    Operation mean("mean", "v_mean", &f.values_src);
+    Operation mode("mode", "v_mode", &f.values_src);
+
+    StatsRegistry reg;
+    reg.add_operation(mean);
+    reg.add_operation(mode);
+
+    reg.stats(FeatureId(1), mean).process(f.coverage, *f.values_src.read_box(f.grid.extent()));
+
+    const auto& stats = reg.stats(FeatureId(1), mode);
+    CHECK( stats.stores_values() );
+    CHECK( stats.mode() == 2.0 );
+    CHECK( stats.variety() == 3 );
+}
+
+TEST_CASE("Combining stats of adjacent features matches stats of their union", "[stats-registry]") {
+    Fixture f;
+    Operation mean("mean", "v_mean", &f.values_src);
+    Operation mode("mode", "v_mode", &f.values_src);
+    Operation weighted("weighted_sum", "v_wsum", &f.values_src, &f.weights_src);
+
+    auto values = f.values_src.read_box(f.grid.extent());
+    auto weights = f.weights_src.read_box(f.grid.extent());
+
+    Raster<float> top{Matrix<float>{{{1, 1}, {0, 0}}}, f.grid};
+    Raster<float> bottom{Matrix<float>{{{0, 0}, {1, 0.5}}}, f.grid};
+
+    StatsRegistry children;
+    StatsRegistry parents;
+    StatsRegistry expected;
+    for (auto* reg : {&children, &parents, &expected}) {
+        reg->add_operation(mean);
+        reg->add_operation(mode);
+        reg->add_operation(weighted);
+    }
+
+    children.stats(FeatureId(1), mean).process(top, *values);
+    children.stats(FeatureId(2), mean).process(bottom, *values);
+    children.stats(FeatureId(1), weighted).process(top, *values, *weights);
+    children.stats(FeatureId(2), weighted).process(bottom, *values, *weights);
+
+    expected.stats(FeatureId("x"), mean).process(f.coverage, *values);
+    expected.stats(FeatureId("x"), weighted).process(f.coverage, *values, *weights);
+
+    parents.combine(FeatureId("x"), children, FeatureId(1));
+    parents.combine(FeatureId("x"), children, FeatureId(2));
+
+    // Unknown features are ignored
+    parents.combine(FeatureId("x"), children, FeatureId(3));
+
+    const auto& a = parents.stats(FeatureId("x"), mean);
+    const auto& b = expected.stats(FeatureId("x"), mean);
+
+    CHECK( a.count() == b.count() );
+    CHECK( a.sum() == b.sum() );
+    CHECK( a.mean() == Approx(b.mean()) );
+    CHECK( a.min() == b.min() );
+    CHECK( a.max() == b.max() );
+    CHECK( a.variance() == Approx(b.variance()) );
+    CHECK( a.mode() == b.mode() );
+    CHECK( a.variety() == b.variety() );
+    CHECK( a.quantile(0.5) == b.quantile(0.5) );
+
+    CHECK( parents.stats(FeatureId("x"), weighted).weighted_sum() == Approx(expected.stats(FeatureId("x"), weighted).weighted_sum()) );
+}
@@ -0,0 +1,65 @@
+#include "catch.hpp"
+
+#include "strategy.h"
+
+using namespace exactextract;
+
+TEST_CASE("Feature-sequential cost counts the blocks touched by each envelope", "[strategy]") {
+    Grid<bounded_extent> grid{{0, 0, 1000, 1000}, 1, 1};
+
+    SECTION("Interior block") {
+        auto est = choose_strategy(grid, grid.extent(), {{0, 990, 10, 1000}}, 3, 256, 256, 10000000);
+        CHECK( est.feature_sequential_cells == 3*256*256 );
+    }
+
+    SECTION("Partial block at edge of raster") {
+        auto est = choose_strategy(grid, grid.extent(), {{995, 0, 1000, 5}}, 1, 256, 256, 10000000);
+        CHECK( est.feature_sequential_cells == 232*232 );
+    }
+
+    SECTION("Envelope spanning blocks") {
+        auto est = choose_strategy(grid, grid.extent(), {{250, 990, 260, 1000}}, 1, 256, 256, 10000000);
+        CHECK( est.feature_sequential_cells == 256*512 );
+    }
+
+    SECTION("Envelope outside raster") {
+        auto est = choose_strategy(grid, grid.extent(), {{2000, 2000, 2010, 2010}, Box::make_empty()}, 10, 256, 256, 10000000);
+        CHECK( est.feature_sequential_cells == 0 );
+    }
+}
+
+TEST_CASE("Raster-sequential cost only counts subgrids intersecting the features", "[strategy]") {
+    Grid<bounded_extent> grid{{0, 0, 1000, 1000}, 1, 1};
+
+    auto est = choose_strategy(grid, {0, 985, 1000, 1000}, {{0, 985, 1000, 1000}}, 1, 1, 1000, 10000);
+
+    // Subgrids of 10 rows each
+    CHECK( est.num_subgrids == 2 );
+    CHECK( est.raster_sequential_cells == 20000 );
+}
+
+TEST_CASE("Strategy selection", "[strategy]") {
+    Grid<bounded_extent> grid{{0, 0, 1000, 1000}, 1, 1};
+
+    std::vector<Box> small;
+    for (size_t i = 0; i < 100; i++) {
+        double x = static_cast<double>(i*10);
+        small.push_back({x, x, x + 1, x + 1});
+    }
+
+    SECTION("Many small features") {
+        auto est = choose_strategy(grid, grid.extent(), small, 100000, 256, 256, 30000000);
+        CHECK( est.strategy == "raster-sequential" );
+        CHECK( est.num_subgrids == 1 );
+    }
+
+    SECTION("Few small features") {
+        auto est = choose_strategy(grid, grid.extent(), small, 5, 256, 256, 30000000);
+        CHECK( est.strategy == "feature-sequential" );
+    }
+
+    SECTION("Few large features") {
+        auto est = choose_strategy(grid, grid.extent(), {{0, 0, 400, 400}, {600, 600, 1000, 1000}}, 2, 256, 256, 30000000);
+        CHECK( est.strategy == "feature-sequential" );
+    }
+}